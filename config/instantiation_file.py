@@ -73,6 +73,11 @@ cache_builder_parts = {
     'ways': '.ways({ways})',
     'log2_ways': '.log2_ways({log2_ways})',
     'pq_size': '.pq_size({pq_size})',
+    'sampled_sets': '.sampled_sets({sampled_sets})',
+    'prefetch_filter_size': '.prefetch_filter_size({prefetch_filter_size})',
+    'prefetcher_profile': '.prefetcher_profile("{prefetcher_profile}")',
+    'replacement_profile': '.replacement_profile("{replacement_profile}")',
+    'prefetch_attribution': '.prefetch_attribution({prefetch_attribution})',
     'mshr_size': '.mshr_size({mshr_size})',
     'latency': '.latency({latency})',
     'hit_latency': '.hit_latency({hit_latency})',
@@ -149,7 +154,11 @@ def get_cache_builder(elem, ul_pairs):
         ('wq_check_full_addr', True): '.set_wq_checks_full_addr()',
         ('wq_check_full_addr', False): '.reset_wq_checks_full_addr()',
         ('virtual_prefetch', True): '.set_virtual_prefetch()',
-        ('virtual_prefetch', False): '.reset_virtual_prefetch()'
+        ('virtual_prefetch', False): '.reset_virtual_prefetch()',
+        ('stack_distance_monitor', True): '.set_stack_distance_monitor()',
+        ('stack_distance_monitor', False): '.reset_stack_distance_monitor()',
+        ('lean_blocks', True): '.set_lean_blocks()',
+        ('lean_blocks', False): '.reset_lean_blocks()'
     }
 
     uppers = (v for v in ul_pairs if v[0] == elem.get('name'))
@@ -158,7 +167,8 @@ def get_cache_builder(elem, ul_pairs):
         '^upper_levels_string': vector_string(f'&channels.at({ul_pairs.index(v)})' for v in uppers),
         '^prefetch_activate_string': ', '.join('access_type::'+t for t in elem.get('prefetch_activate',[])),
         '^replacement_string': ', '.join(f'class {k["class"]}' for k in elem.get('_replacement_data',[])),
-        '^prefetcher_string': ', '.join(f'class {k["class"]}' for k in elem.get('_prefetcher_data',[])),
+        '^prefetcher_string': ', '.join((f'champsim::shadow_prefetcher<class {k["class"]}>' if k.get('_shadow') else f'class {k["class"]}')
+                                        for k in elem.get('_prefetcher_data',[])),
         '^lower_level_queues': f'channels.at({ul_pairs.index((elem.get("lower_level"), elem.get("name")))})'
     }
     if 'frequency' in elem:
@@ -327,6 +337,8 @@ def get_instantiation_lines(cores, caches, ptws, pmem, vmem, build_id):
         *(c['_replacement_data'] for c in caches)
     ))
     yield from module_include_files(datas)
+    if any(p.get('_shadow', False) for c in caches for p in c.get('_prefetcher_data', [])):
+        yield '#include "shadow_prefetcher.h"'
 
     # Get fastest clock period in picoseconds
     global_clock_period = int(1000000/max(x['frequency'] for x in itertools.chain(cores, caches, ptws, (pmem,))))
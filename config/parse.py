@@ -404,7 +404,10 @@ class NormalizedConfiguration:
 
                 # Get module path names and unique module names
                '_replacement_data': list(map(replacement_parse, util.wrap_list(cache.get('replacement', 'lru')))),
-               '_prefetcher_data': [*map(functools.partial(prefetcher_parse, cache=cache), util.wrap_list(cache.get('prefetcher', 'no')))]
+               '_prefetcher_data': [
+                   *map(functools.partial(prefetcher_parse, cache=cache), util.wrap_list(cache.get('prefetcher', 'no'))),
+                   *({**prefetcher_parse(mod, cache), '_shadow': True} for mod in util.wrap_list(cache.get('shadow_prefetcher', [])))
+               ]
             } for k,cache in caches.items())
         )
 
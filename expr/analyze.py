@@ -10,6 +10,7 @@ from tqdm import tqdm
 import time
 import random
 import subprocess
+from utils.event_log import read_events, to_text_fields
 RED = '\033[91m'
 GREEN = '\033[92m'
 YELLOW = '\033[93m'
@@ -108,9 +109,19 @@ for result in glob.glob(os.path.join(f"./result/{args.prefetcher}",f"*_breif.txt
 
 
 
-for log_file in glob.glob(os.path.join(LOG_PATH+args.prefetcher, '*.txt')):
+def read_log_fields(log_file):
+    ''' Yield the fields of each event, from either a text log or a binary event log '''
+    if log_file.endswith(".events.gz"):
+        yield from map(to_text_fields, read_events(log_file))
+    else:
+        with open(log_file) as f:
+            for line in f:
+                yield line.strip().split(" ")
+
+log_files = glob.glob(os.path.join(LOG_PATH+args.prefetcher, '*.txt')) + glob.glob(os.path.join(LOG_PATH+args.prefetcher, '*.events.gz'))
+for log_file in log_files:
     
-    t = os.path.splitext(os.path.basename(log_file))[0]
+    t = os.path.basename(log_file).removesuffix(".events.gz").removesuffix(".txt")
     if not args.traces:
         args.traces = []
     if t in already_analyzed and t not in args.traces:
@@ -130,30 +141,28 @@ for log_file in glob.glob(os.path.join(LOG_PATH+args.prefetcher, '*.txt')):
     miss_l3pq = 0
     miss_nolate = 0
     print(f"{CYAN}{t}{END}: Reading logs from {YELLOW}{log_file}{END}")
-    with open(log_file) as f:
-        for line in tqdm(f):
-            lst = line.strip().split(" ")
-            if lst[1] == "HIT":
-                logs.append(hit_log(int(lst[0]), int(lst[2], 16), int(lst[3], 16), int(lst[4],16), [int(x, 16) for x in lst[5:]]))
-            if lst[1] == "MISS":
-                if lst[2] == "MSHR":
-                    miss_mshr +=1
-                elif lst[2] == "L2PQ":
-                    miss_l2pq += 1
-                elif lst[2] == "L3PQ":
-                    miss_l3pq += 1
-                else:
-                    miss_nolate += 1
-                logs.append(miss_log(int(lst[0]), lst[2], int(lst[3], 16), int(lst[4], 16), int(lst[5],16), [int(x, 16) for x in lst[6:]]))
-            elif lst[1] == "ADD":
-                add+=1
-                logs.append(add_log(int(lst[0]), int(lst[2],16), int(lst[3],16)))
-            elif lst[1] == "EVICT":
-                evict += 1
-                logs.append(evict_log(int(lst[0]), lst[2], int(lst[3],16), int(lst[4],16)))
-            # elif lst[1] == "ISSUE":
-            #     issue += 1
-            #     logs.append(issue_log(int(lst[0]), lst[2], int(lst[3],16), int(lst[4],16), int(lst[5],16)))
+    for lst in tqdm(read_log_fields(log_file)):
+        if lst[1] == "HIT":
+            logs.append(hit_log(int(lst[0]), int(lst[2], 16), int(lst[3], 16), int(lst[4],16), [int(x, 16) for x in lst[5:]]))
+        if lst[1] == "MISS":
+            if lst[2] == "MSHR":
+                miss_mshr +=1
+            elif lst[2] == "L2PQ":
+                miss_l2pq += 1
+            elif lst[2] == "L3PQ":
+                miss_l3pq += 1
+            else:
+                miss_nolate += 1
+            logs.append(miss_log(int(lst[0]), lst[2], int(lst[3], 16), int(lst[4], 16), int(lst[5],16), [int(x, 16) for x in lst[6:]]))
+        elif lst[1] == "ADD":
+            add+=1
+            logs.append(add_log(int(lst[0]), int(lst[2],16), int(lst[3],16)))
+        elif lst[1] == "EVICT":
+            evict += 1
+            logs.append(evict_log(int(lst[0]), lst[2], int(lst[3],16), int(lst[4],16)))
+        # elif lst[1] == "ISSUE":
+        #     issue += 1
+        #     logs.append(issue_log(int(lst[0]), lst[2], int(lst[3],16), int(lst[4],16), int(lst[5],16)))
     
 
     print(f"{CYAN}{t}{END}: Miss(No late prefetch): {miss_nolate}, Miss(PR send to MSHR): {miss_mshr}, Miss(PR send to L2 PQ): {miss_l2pq}, Miss(PR send to L3 PQ): {miss_l3pq}, Add: {add}, Evict: {evict}")
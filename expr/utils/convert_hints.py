@@ -0,0 +1,54 @@
+#!/usr/bin/env python3
+import argparse
+import struct
+
+# Must match prophet::hint and prophet::hint_table in prefetcher/prophet_profile/hints.h
+MAGIC = b"PPHINT01"
+COUNT = struct.Struct("<Q")
+RECORD = struct.Struct("<QiI")
+INSERT = 1
+
+
+def read_text_hints(path):
+    '''
+    Read a text profile into a dictionary of IP to (priority, may insert).
+
+    Each line is an IP in hexadecimal, its replacement priority, and optionally 0 if the IP must not insert metadata. Blank lines and lines beginning
+    with # are ignored. If an IP appears more than once, its last line wins.
+    '''
+    hints = {}
+    with open(path) as f:
+        for lineno, line in enumerate(f, start=1):
+            fields = line.split()
+            if not fields or fields[0].startswith('#'):
+                continue
+            if len(fields) not in (2, 3):
+                raise ValueError(f"{path}:{lineno}: expected an IP, a priority, and an optional insert flag")
+            ip = int(fields[0], 16)
+            priority = int(fields[1])
+            may_insert = len(fields) < 3 or int(fields[2]) != 0
+            hints[ip] = (priority, may_insert)
+    return hints
+
+
+def write_hints(path, hints):
+    '''
+    Write a dictionary of IP to (priority, may insert) as a binary profile that prophet_profile can map.
+    '''
+    with open(path, "wb") as f:
+        f.write(MAGIC)
+        f.write(COUNT.pack(len(hints)))
+        for ip in sorted(hints):
+            priority, may_insert = hints[ip]
+            f.write(RECORD.pack(ip, priority, INSERT if may_insert else 0))
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Convert a text prophet profile to the binary format loaded with --prefetcher-profile')
+    parser.add_argument('text_profile')
+    parser.add_argument('binary_profile')
+    args = parser.parse_args()
+
+    hints = read_text_hints(args.text_profile)
+    write_hints(args.binary_profile, hints)
+    print(f"{len(hints)} hints written to {args.binary_profile}")
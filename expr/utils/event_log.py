@@ -0,0 +1,63 @@
+import gzip
+import struct
+from collections import namedtuple
+from enum import Enum
+
+# Must match prophet::event_record in prefetcher/prophet_profile/event_log.h
+MAGIC = b"PPEVLOG1"
+RECORD = struct.Struct("<QQQQIBBH")
+TRIGGER = struct.Struct("<Q")
+
+class event_type(Enum):
+    MISS = 0
+    HIT = 1
+    ADD = 2
+    EVICT = 3
+    ISSUE = 4
+
+class event_detail(Enum):
+    NONE = 0
+    MSHR = 1
+    L2PQ = 2
+    L3PQ = 3
+    CAPACITY = 4
+    CONFLICT = 5
+    MT = 6
+    MRB = 7
+
+event = namedtuple("event", ["cycle", "type", "detail", "ip", "addr", "other", "triggers"])
+
+
+def read_events(path):
+    '''
+    Yield each event in a prophet_profile event log, in the order it was recorded.
+    '''
+    with gzip.open(path, "rb") as f:
+        if f.read(len(MAGIC)) != MAGIC:
+            raise ValueError(f"{path} is not a prophet_profile event log")
+        while True:
+            header = f.read(RECORD.size)
+            if not header:
+                return
+            if len(header) != RECORD.size:
+                raise ValueError(f"{path} is truncated")
+            cycle, ip, addr, other, trigger_count, etype, detail, _ = RECORD.unpack(header)
+            raw_triggers = f.read(TRIGGER.size * trigger_count)
+            triggers = [t for (t,) in TRIGGER.iter_unpack(raw_triggers)]
+            yield event(cycle, event_type(etype), event_detail(detail), ip, addr, other, triggers)
+
+
+def to_text_fields(e):
+    '''
+    Format an event as the whitespace-separated fields of the old text log, so that text-based analyses can consume either format.
+    '''
+    if e.type == event_type.MISS:
+        late = e.detail.name if e.detail != event_detail.NONE else "NO"
+        return [str(e.cycle), "MISS", late, f"{e.addr:x}", f"{e.ip:x}", f"{e.other:x}", *(f"{t:x}" for t in e.triggers)]
+    if e.type == event_type.HIT:
+        return [str(e.cycle), "HIT", f"{e.addr:x}", f"{e.ip:x}", f"{e.other:x}", *(f"{t:x}" for t in e.triggers)]
+    if e.type == event_type.ADD:
+        return [str(e.cycle), "ADD", f"{e.addr:x}", f"{e.other:x}"]
+    if e.type == event_type.EVICT:
+        return [str(e.cycle), "EVICT", e.detail.name, f"{e.addr:x}", f"{e.other:x}"]
+    return [str(e.cycle), "ISSUE", e.detail.name, f"{e.ip:x}", f"{e.addr:x}", f"{e.other:x}"]
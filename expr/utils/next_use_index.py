@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+import argparse
+import gzip
+import lzma
+import struct
+from collections import OrderedDict, deque
+
+# Must match belady::next_use_window and belady::next_use_record in replacement/opt/next_use_window.h
+MAGIC = b"OPTNXT01"
+RECORD = struct.Struct("<QQ")
+NEVER = 2**64 - 1
+DEFAULT_WINDOW = 2**18 # belady::next_use_window::DEFAULT_CAPACITY
+
+# Must match input_instr in inc/trace_instruction.h
+INSTR = struct.Struct("<QBB2B4B2Q4Q")
+
+
+def open_trace(path):
+    if path.endswith('.xz'):
+        return lzma.open(path, 'rb')
+    if path.endswith('.gz'):
+        return gzip.open(path, 'rb')
+    return open(path, 'rb')
+
+
+def trace_addresses(path, max_instructions=None):
+    '''
+    Yield the memory addresses accessed by each instruction of a ChampSim trace, sources before destinations, without repeats within an instruction.
+    '''
+    with open_trace(path) as f:
+        count = 0
+        while max_instructions is None or count < max_instructions:
+            raw = f.read(INSTR.size)
+            if len(raw) < INSTR.size:
+                return
+            fields = INSTR.unpack(raw)
+            destinations, sources = fields[9:11], fields[11:15]
+            yield from dict.fromkeys(a for a in (*sources, *destinations) if a != 0)
+            count += 1
+
+
+def text_addresses(path):
+    '''
+    Yield the addresses in a text stream, one hexadecimal address per line. Blank lines and lines beginning with # are ignored.
+    '''
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if fields and not fields[0].startswith('#'):
+                yield int(fields[0], 16)
+
+
+def lru_misses(blocks, sets, ways):
+    '''
+    Yield the blocks that miss in an LRU cache of the given geometry.
+    '''
+    contents = [OrderedDict() for _ in range(sets)]
+    for block in blocks:
+        s = contents[block % sets]
+        if block in s:
+            s.move_to_end(block)
+            continue
+        if len(s) >= ways:
+            s.popitem(last=False)
+        s[block] = None
+        yield block
+
+
+def next_uses(blocks, window=DEFAULT_WINDOW):
+    '''
+    Yield each access and the position of the next access to the same block, in order.
+
+    Only the most recent accesses are held, so a next use that is more than the given number of accesses ahead is yielded as NEVER. The opt replacement
+    policy reads the index through a window of the same size, so such a use is never in its window either.
+    '''
+    pending = deque() # [block, next use] of the accesses whose next use may still be found
+    latest = {} # the position of the most recent pending access to each block
+    base = 0 # the position of the first pending access
+    for i, block in enumerate(blocks):
+        if block in latest:
+            pending[latest[block] - base][1] = i
+        latest[block] = i
+        pending.append([block, NEVER])
+
+        if len(pending) > window:
+            oldest, next_use = pending.popleft()
+            if latest[oldest] == base:
+                del latest[oldest]
+            base += 1
+            yield oldest, next_use
+
+    for block, next_use in pending:
+        yield block, next_use
+
+
+def write_index(path, records):
+    '''
+    Write the accesses and their next uses as an index that the opt replacement policy can read. Returns the number of accesses written.
+    '''
+    count = 0
+    with gzip.open(path, 'wb') as f:
+        f.write(MAGIC)
+        for block, next_use in records:
+            f.write(RECORD.pack(block, next_use))
+            count += 1
+    return count
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Write the next-use index loaded by opt replacement with --replacement-profile')
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument('--trace', help='A ChampSim trace, optionally compressed with xz or gzip')
+    source.add_argument('--stream', help='A text file of hexadecimal addresses, in the order the cache sees them')
+    parser.add_argument('--max-instructions', type=int, help='Read only this many instructions of the trace')
+    parser.add_argument('--block-size', type=int, default=64, help='The block size of the cache, in bytes')
+    parser.add_argument('--filter-sets', type=int, help='Keep only the misses of an LRU cache with this many sets')
+    parser.add_argument('--filter-ways', type=int, default=8, help='The associativity of the filtering cache')
+    parser.add_argument('--window', type=int, default=DEFAULT_WINDOW, help='How many accesses ahead to look for a next use')
+    parser.add_argument('index')
+    args = parser.parse_args()
+
+    offset_bits = args.block_size.bit_length() - 1
+    addresses = trace_addresses(args.trace, args.max_instructions) if args.trace else text_addresses(args.stream)
+    blocks = (addr >> offset_bits for addr in addresses)
+    if args.filter_sets:
+        blocks = lru_misses(blocks, args.filter_sets, args.filter_ways)
+
+    count = write_index(args.index, next_uses(blocks, args.window))
+    print(f"{count} accesses written to {args.index}")
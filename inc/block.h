@@ -21,14 +21,19 @@
 
 namespace champsim
 {
+/**
+ * One way of a cache. Builds that define LEAN_CACHE_BLOCKS drop the virtual address and data, and the cache keeps them alongside only if it needs them.
+ */
 struct cache_block {
   bool valid = false;
   bool prefetch = false;
   bool dirty = false;
 
   champsim::address address{};
+#ifndef LEAN_CACHE_BLOCKS
   champsim::address v_address{};
   champsim::address data{};
+#endif
 
   uint32_t pf_metadata = 0;
 };
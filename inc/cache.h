@@ -25,13 +25,15 @@
 #include <array>
 #include <cstddef> // for size_t
 #include <cstdint> // for uint64_t, uint32_t, uint8_t
-#include <deque>
+#include <iosfwd>
 #include <iterator> // for size
 #include <limits>   // for numeric_limits
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "address.h"
@@ -44,6 +46,12 @@
 #include "chrono.h"
 #include "modules.h"
 #include "operable.h"
+#include "prefetch_attribution.h"
+#include "prefetch_filter.h"
+#include "set_way_heatmap.h"
+#include "shadow_directory.h"
+#include "stack_distance_monitor.h"
+#include "util/ring_buffer.h"
 #include "util/to_underlying.h" // for to_underlying
 #include "waitable.h"
 
@@ -66,6 +74,7 @@ class CACHE : public champsim::operable
 
     uint32_t pf_metadata;
     uint32_t cpu;
+    champsim::prefetch_attribution::id_type pf_trigger = champsim::prefetch_attribution::NONE;
 
     access_type type;
     bool prefetch_from_this;
@@ -77,11 +86,11 @@ class CACHE : public champsim::operable
 
     champsim::chrono::clock::time_point event_cycle = champsim::chrono::clock::time_point::max();
 
-    std::vector<uint64_t> instr_depend_on_me{};
-    std::vector<std::deque<response_type>*> to_return{};
+    champsim::small_vector<uint64_t, 4> instr_depend_on_me{};
+    champsim::small_vector<champsim::ring_buffer<response_type>*, 2> to_return{};
 
-    explicit tag_lookup_type(request_type req) : tag_lookup_type(req, false, false) {}
-    tag_lookup_type(const request_type& req, bool local_pref, bool skip);
+    explicit tag_lookup_type(request_type req) : tag_lookup_type(std::move(req), false, false) {}
+    tag_lookup_type(request_type req, bool local_pref, bool skip);
   };
 
 public:
@@ -97,6 +106,7 @@ public:
     };
     champsim::waitable<returned_value> data_promise{};
     uint32_t cpu;
+    champsim::prefetch_attribution::id_type pf_trigger;
 
     access_type type;
     bool prefetch_from_this;
@@ -106,8 +116,8 @@ public:
 
     champsim::chrono::clock::time_point time_enqueued;
 
-    std::vector<uint64_t> instr_depend_on_me{};
-    std::vector<std::deque<response_type>*> to_return{};
+    champsim::small_vector<uint64_t, 4> instr_depend_on_me{};
+    champsim::small_vector<champsim::ring_buffer<response_type>*, 2> to_return{};
 
     mshr_type(const tag_lookup_type& req, champsim::chrono::clock::time_point _time_enqueued);
     static mshr_type merge(mshr_type predecessor, mshr_type successor);
@@ -121,10 +131,11 @@ private:
   bool handle_fill(const mshr_type& fill_mshr);
   bool handle_miss(const tag_lookup_type& handle_pkt);
   bool handle_write(const tag_lookup_type& handle_pkt);
+  void record_stack_position(const tag_lookup_type& handle_pkt);
   void finish_packet(const response_type& packet);
   void finish_translation(const response_type& packet);
 
-  void issue_translation(tag_lookup_type& q_entry) const;
+  bool issue_translation(tag_lookup_type& q_entry) const; // false if the translation queue turned the request away
 
 public:
   using BLOCK = champsim::cache_block;
@@ -136,6 +147,11 @@ private:
   std::pair<set_type::iterator, set_type::iterator> get_set_span(champsim::address address);
   [[nodiscard]] std::pair<set_type::const_iterator, set_type::const_iterator> get_set_span(champsim::address address) const;
   [[nodiscard]] long get_set_index(champsim::address address) const;
+  [[nodiscard]] bool is_sampled_set(champsim::address address) const;
+  [[nodiscard]] bool is_resident(champsim::address address) const;
+  [[nodiscard]] bool is_redundant_prefetch(champsim::address pf_addr) const;
+  bool issue_prefetch(const champsim::prefetch_request& request, bool duplicate);
+  [[nodiscard]] uint64_t shadow_key(champsim::address address) const;
 
   template <typename T>
   bool should_activate_prefetcher(const T& pkt) const;
@@ -145,13 +161,30 @@ private:
 
   template <typename T>
   champsim::address module_address(const T& element) const;
+  [[nodiscard]] champsim::address module_address(champsim::address address, champsim::address v_address) const;
+
+  [[nodiscard]] champsim::address v_address_of(set_type::const_iterator way) const;
+  [[nodiscard]] champsim::address data_of(set_type::const_iterator way) const;
+  void store_payload(set_type::const_iterator way, champsim::address v_address, champsim::address data);
 
   auto matches_address(champsim::address address) const;
   std::pair<mshr_type, request_type> mshr_and_forward_packet(const tag_lookup_type& handle_pkt);
 
-  std::deque<tag_lookup_type> internal_PQ{};
-  std::deque<tag_lookup_type> inflight_tag_check{};
-  std::deque<tag_lookup_type> translation_stash{};
+  champsim::ring_buffer<tag_lookup_type> internal_PQ{};
+  champsim::ring_buffer<tag_lookup_type> inflight_tag_check{};
+  champsim::ring_buffer<tag_lookup_type> translation_stash{};
+
+  // The number of entries in inflight_tag_check and translation_stash that are waiting on each virtual page
+  std::unordered_map<uint64_t, std::size_t> untranslated_pages{};
+  // The number of untranslated entries whose translation request was turned away by a full translation queue
+  std::size_t translations_to_retry = 0;
+  [[nodiscard]] static uint64_t translation_key(champsim::address v_address);
+
+  // The demand IP whose access the prefetchers are handling, so that the prefetches they issue are attributed to it
+  std::optional<uint64_t> pf_trigger_ip{};
+
+  // The shadow directory that receives prefetches instead of the internal PQ, while a shadow prefetcher is running
+  std::optional<std::size_t> prefetch_shadow{};
 
 public:
   std::vector<channel_type*> upper_levels;
@@ -180,19 +213,36 @@ public:
   champsim::chrono::clock::duration HIT_LATENCY;
   champsim::chrono::clock::duration FILL_LATENCY;
   champsim::data::bits OFFSET_BITS;
+  uint64_t SET_INDEX_MASK; // applied to the block number, so that set indexing is a shift and a mask
   set_type block{static_cast<typename set_type::size_type>(NUM_SET * NUM_WAY)};
+  bool keep_block_v_address;                      // false if the blocks are lean and the cache does not prefetch virtually
+  bool keep_block_data;                           // false if the blocks are lean
+  std::vector<champsim::address> block_v_address; // only used if champsim::lean_cache_blocks, since the blocks then lack a virtual address
+  std::vector<champsim::address> block_data;      // only used if champsim::lean_cache_blocks, since the blocks then lack data
+  std::vector<uint32_t> block_cpu;                // the core whose request filled each block
+  std::vector<uint64_t> block_last_use;           // when each block was last filled or hit, counted in block_use_clock
+  uint64_t block_use_clock = 0;
   champsim::bandwidth::maximum_type MAX_TAG, MAX_FILL;
   bool prefetch_as_load;
   bool match_offset_bits;
   bool virtual_prefetch;
+  uint32_t SET_SAMPLE_STRIDE; // one in every SET_SAMPLE_STRIDE sets is modeled, and its statistics are weighted by this value
+  std::optional<champsim::stack_distance_monitor> stack_monitor; // covers only the sampled sets
+  std::optional<champsim::prefetch_filter> pf_filter;
+  std::optional<champsim::prefetch_attribution> pf_attribution;
+  std::vector<champsim::prefetch_attribution::id_type> block_pf_trigger; // empty unless prefetches are attributed
+  std::vector<champsim::shadow_directory> shadow_directories{};          // one for each shadow prefetcher
+  std::string prefetcher_profile; // loaded by profile-guided prefetchers, if not empty
+  std::string replacement_profile; // loaded by trace-driven replacement policies, if not empty
+  std::optional<champsim::set_way_heatmap> heatmap{};            // only present if champsim::record_heatmap
   std::vector<access_type> pref_activate_mask;
 
   using stats_type = cache_stats;
 
   stats_type sim_stats, roi_stats;
 
-  std::deque<mshr_type> MSHR;
-  std::deque<mshr_type> inflight_writes;
+  champsim::ring_buffer<mshr_type> MSHR;
+  champsim::ring_buffer<mshr_type> inflight_writes;
 
   long operate() final;
   void initialize() final;
@@ -231,6 +281,24 @@ public:
   long invalidate_entry(champsim::address inval_addr);
   bool prefetch_line(champsim::address pf_addr, bool fill_this_level, uint32_t prefetch_metadata);
 
+  /**
+   * Issue a batch of prefetches. Each request is handled as prefetch_line() would, except that a request for the same block as an earlier request in the
+   * batch is counted as requested and filtered, but not issued.
+   * Returns the number of requests, from the front of the batch, that were accepted. Once a request does not fit in the prefetch queue, every request
+   * after it is dropped as well.
+   */
+  std::size_t prefetch_lines(const std::vector<champsim::prefetch_request>& requests);
+
+  /**
+   * Add a shadow directory, for a prefetcher that observes the cache without issuing, and return its index.
+   */
+  std::size_t add_shadow_directory();
+
+  /**
+   * Record the prefetches requested from now on in the given shadow directory instead of issuing them, or resume issuing them if there is none.
+   */
+  void divert_prefetches(std::optional<std::size_t> shadow);
+
   [[deprecated]] bool prefetch_line(uint64_t pf_addr, bool fill_this_level, uint32_t prefetch_metadata);
 
   [[deprecated("Use CACHE::prefetch_line(pf_addr, fill_this_level, prefetch_metadata) instead.")]] bool
@@ -238,6 +306,19 @@ public:
 
   void print_deadlock() final;
 
+  /**
+   * Write the valid blocks of the cache to a snapshot, tagged with the cache's name and geometry.
+   * The blocks of each set are written from least to most recently used, along with their way and the core that filled them.
+   */
+  void save_snapshot(std::ostream& stream) const;
+
+  /**
+   * Replace the contents of the cache with a snapshot taken from a cache of the same name and geometry.
+   * Each block returns to its way, and the replacement policy sees the fills in the recorded order, so that its recency state is rebuilt.
+   * Throws std::runtime_error if the snapshot is malformed, or std::invalid_argument if it was taken from a different cache or geometry.
+   */
+  void load_snapshot(std::istream& stream);
+
 #include "module_decl.inc"
 
   struct prefetcher_module_concept {
@@ -354,10 +435,31 @@ public:
   explicit CACHE(champsim::cache_builder<champsim::cache_builder_module_type_holder<Ps...>, champsim::cache_builder_module_type_holder<Rs...>> b)
       : champsim::operable(b.m_clock_period), upper_levels(b.m_uls), lower_level(b.m_ll), lower_translate(b.m_lt), NAME(b.m_name), NUM_SET(b.get_num_sets()),
         NUM_WAY(b.get_num_ways()), available_ways(b.get_num_ways()), MSHR_SIZE(b.get_num_mshrs()), PQ_SIZE(b.m_pq_size), HIT_LATENCY(b.get_hit_latency() * b.m_clock_period),
-        FILL_LATENCY(b.get_fill_latency() * b.m_clock_period), OFFSET_BITS(b.m_offset_bits), MAX_TAG(b.get_tag_bandwidth()), MAX_FILL(b.get_fill_bandwidth()),
-        prefetch_as_load(b.m_pref_load), match_offset_bits(b.m_wq_full_addr), virtual_prefetch(b.m_va_pref), pref_activate_mask(b.m_pref_act_mask),
+        FILL_LATENCY(b.get_fill_latency() * b.m_clock_period), OFFSET_BITS(b.m_offset_bits),
+        SET_INDEX_MASK(champsim::msl::bitmask(champsim::data::bits{champsim::lg2(b.get_num_sets())})),
+        keep_block_v_address(!b.m_lean_blocks || b.m_va_pref), keep_block_data(!b.m_lean_blocks),
+        block_v_address((champsim::lean_cache_blocks && keep_block_v_address) ? std::size_t{b.get_num_sets()} * b.get_num_ways() : 0),
+        block_data((champsim::lean_cache_blocks && keep_block_data) ? std::size_t{b.get_num_sets()} * b.get_num_ways() : 0),
+        block_cpu(std::size_t{b.get_num_sets()} * b.get_num_ways()),
+        block_last_use(std::size_t{b.get_num_sets()} * b.get_num_ways()), MAX_TAG(b.get_tag_bandwidth()), MAX_FILL(b.get_fill_bandwidth()),
+        prefetch_as_load(b.m_pref_load), match_offset_bits(b.m_wq_full_addr), virtual_prefetch(b.m_va_pref), SET_SAMPLE_STRIDE(b.get_sample_stride()),
+        stack_monitor(b.m_sd_monitor ? std::optional<champsim::stack_distance_monitor>{std::in_place, b.get_num_sets() / b.get_sample_stride(), b.get_num_ways()}
+                                     : std::nullopt),
+        pf_filter(b.m_pf_filter_size.has_value() ? std::optional<champsim::prefetch_filter>{std::in_place, b.m_pf_filter_size.value()} : std::nullopt),
+        pf_attribution(b.m_pf_attribution.has_value() ? std::optional<champsim::prefetch_attribution>{std::in_place, b.m_pf_attribution.value()}
+                                                      : std::nullopt),
+        block_pf_trigger(b.m_pf_attribution.has_value() ? std::size_t{b.get_num_sets()} * b.get_num_ways() : 0, champsim::prefetch_attribution::NONE),
+        prefetcher_profile(b.m_pf_profile), replacement_profile(b.m_repl_profile), pref_activate_mask(b.m_pref_act_mask),
         pref_module_pimpl(std::make_unique<prefetcher_module_model<Ps...>>(this)), repl_module_pimpl(std::make_unique<replacement_module_model<Rs...>>(this))
   {
+    // Unbounded queues grow on demand, so only preallocate those with a configured size
+    if (PQ_SIZE != std::numeric_limits<std::size_t>::max()) {
+      internal_PQ.reserve(PQ_SIZE);
+    }
+
+    if constexpr (champsim::record_heatmap) {
+      heatmap.emplace(NUM_SET, NUM_WAY);
+    }
   }
 
   CACHE(const CACHE&) = delete;
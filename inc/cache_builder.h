@@ -47,6 +47,11 @@ struct cache_builder_base {
   double m_sets_factor{64};
   std::optional<uint32_t> m_ways{};
   std::size_t m_pq_size{std::numeric_limits<std::size_t>::max()};
+  std::optional<uint32_t> m_sampled_sets{};
+  std::optional<std::size_t> m_pf_filter_size{};
+  std::string m_pf_profile{};
+  std::string m_repl_profile{};
+  std::optional<std::size_t> m_pf_attribution{};
   std::optional<uint32_t> m_mshr_size{};
   std::optional<uint64_t> m_hit_lat{};
   std::optional<uint64_t> m_fill_lat{};
@@ -57,6 +62,8 @@ struct cache_builder_base {
   bool m_pref_load{};
   bool m_wq_full_addr{};
   bool m_va_pref{};
+  bool m_sd_monitor{};
+  bool m_lean_blocks{};
 
   std::vector<access_type> m_pref_act_mask{access_type::LOAD, access_type::PREFETCH};
   std::vector<champsim::channel*> m_uls{};
@@ -88,6 +95,7 @@ class cache_builder : public detail::cache_builder_base
   uint64_t get_hit_latency() const;
   uint64_t get_fill_latency() const;
   uint64_t get_total_latency() const;
+  uint32_t get_sample_stride() const;
 
 public:
   cache_builder() = default;
@@ -142,6 +150,38 @@ public:
    */
   self_type& pq_size(uint32_t pq_size_);
 
+  /**
+   * Specify the number of sets to model in detail.
+   * Accesses to the remaining sets are filtered out at the tag check, and the statistics of the sampled sets are scaled to cover them.
+   * If this is not specified, every set is modeled.
+   */
+  self_type& sampled_sets(uint32_t sampled_sets_);
+
+  /**
+   * Specify the number of bits in the filter of recently issued prefetches and misses.
+   * Prefetches for blocks that are already resident, in the MSHR, or waiting for a tag check are then dropped and counted as filtered.
+   * If this is not specified, no prefetches are filtered.
+   */
+  self_type& prefetch_filter_size(std::size_t prefetch_filter_size_);
+
+  /**
+   * Specify the path of a profile for profile-guided prefetchers to load.
+   * If this is not specified, no profile is loaded.
+   */
+  self_type& prefetcher_profile(std::string prefetcher_profile_);
+
+  /**
+   * Specify the path of a profile for trace-driven replacement policies to load.
+   * If this is not specified, no profile is loaded.
+   */
+  self_type& replacement_profile(std::string replacement_profile_);
+
+  /**
+   * Specify the number of IPs for which prefetch outcomes are attributed, as triggers of prefetches and as demands covered by them.
+   * The IPs with the most events are kept. If this is not specified, prefetches are not attributed.
+   */
+  self_type& prefetch_attribution(std::size_t prefetch_attribution_);
+
   /**
    * Specify the number of MSHRs.
    * If this is not specified, it will be derived from the number of sets, fill latency, and fill bandwidth.
@@ -214,6 +254,28 @@ public:
    */
   self_type& reset_virtual_prefetch();
 
+  /**
+   * Specify that the cache should record the LRU stack position of each access, to produce miss curves for every associativity.
+   */
+  self_type& set_stack_distance_monitor();
+
+  /**
+   * Specify that the cache should not record LRU stack positions.
+   */
+  self_type& reset_stack_distance_monitor();
+
+  /**
+   * Specify that the cache's blocks should not store their data.
+   * Only translation caches use the data of their blocks, so other caches can drop it. The virtual address is also dropped, unless the cache prefetches
+   * with virtual addresses. Host memory is only saved in builds that define LEAN_CACHE_BLOCKS.
+   */
+  self_type& set_lean_blocks();
+
+  /**
+   * Specify that the cache's blocks should store their data and virtual address.
+   */
+  self_type& reset_lean_blocks();
+
   /**
    * Specify the ``access_type`` values that should activate the prefetcher.
    */
@@ -320,6 +382,15 @@ auto champsim::cache_builder<P, R>::get_total_latency() const -> uint64_t
   return std::max(latency, uint64_t{2});
 }
 
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::get_sample_stride() const -> uint32_t
+{
+  const auto num_sets = get_num_sets();
+  if (!m_sampled_sets.has_value() || m_sampled_sets.value() == 0 || m_sampled_sets.value() >= num_sets)
+    return 1;
+  return num_sets / champsim::next_pow2(m_sampled_sets.value());
+}
+
 template <typename P, typename R>
 auto champsim::cache_builder<P, R>::name(std::string name_) -> self_type&
 {
@@ -390,6 +461,41 @@ auto champsim::cache_builder<P, R>::pq_size(uint32_t pq_size_) -> self_type&
   return *this;
 }
 
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::sampled_sets(uint32_t sampled_sets_) -> self_type&
+{
+  m_sampled_sets = sampled_sets_;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::prefetch_filter_size(std::size_t prefetch_filter_size_) -> self_type&
+{
+  m_pf_filter_size = prefetch_filter_size_;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::prefetcher_profile(std::string prefetcher_profile_) -> self_type&
+{
+  m_pf_profile = prefetcher_profile_;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::replacement_profile(std::string replacement_profile_) -> self_type&
+{
+  m_repl_profile = replacement_profile_;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::prefetch_attribution(std::size_t prefetch_attribution_) -> self_type&
+{
+  m_pf_attribution = prefetch_attribution_;
+  return *this;
+}
+
 template <typename P, typename R>
 auto champsim::cache_builder<P, R>::mshr_size(uint32_t mshr_size_) -> self_type&
 {
@@ -487,6 +593,34 @@ auto champsim::cache_builder<P, R>::reset_virtual_prefetch() -> self_type&
   return *this;
 }
 
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::set_stack_distance_monitor() -> self_type&
+{
+  m_sd_monitor = true;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::reset_stack_distance_monitor() -> self_type&
+{
+  m_sd_monitor = false;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::set_lean_blocks() -> self_type&
+{
+  m_lean_blocks = true;
+  return *this;
+}
+
+template <typename P, typename R>
+auto champsim::cache_builder<P, R>::reset_lean_blocks() -> self_type&
+{
+  m_lean_blocks = false;
+  return *this;
+}
+
 template <typename P, typename R>
 template <typename... Elems>
 auto champsim::cache_builder<P, R>::prefetch_activate(Elems... pref_act_elems) -> self_type&
@@ -5,29 +5,53 @@
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "channel.h"
 #include "event_counter.h"
+#include "prefetch_attribution.h"
+#include "shadow_directory.h"
 
 struct cache_stats {
   std::string name;
   // prefetch stats
   uint64_t pf_requested = 0;
   uint64_t pf_dropped = 0;
+  uint64_t pf_filtered = 0;
   uint64_t pf_issued = 0;
   uint64_t pf_useful = 0;
   uint64_t pf_useless = 0;
   uint64_t pf_fill = 0;
   uint64_t pf_late = 0;
 
+  // Per-IP prefetch outcomes, from the heaviest IP to the lightest, if prefetches are attributed
+  std::vector<champsim::ip_prefetch_stats> pf_by_ip{};
+
+  // The outcomes of each shadow prefetcher, in the order they were configured
+  std::vector<champsim::shadow_prefetch_stats> pf_shadow{};
+
   champsim::stats::event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>> hits = {};
   champsim::stats::event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>> misses = {};
   champsim::stats::event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>> mshr_merge = {};
   champsim::stats::event_counter<std::pair<access_type, std::remove_cv_t<decltype(NUM_CPUS)>>> mshr_return = {};
 
   long total_miss_latency_cycles{};
+
+  // LRU stack position of each access, if the stack distance monitor is enabled. Accesses deeper than the associativity count in stack_misses.
+  std::vector<long> stack_position_hits{};
+  long stack_misses{};
 };
 
 cache_stats operator-(cache_stats lhs, cache_stats rhs);
 
+/**
+ * The number of hits that an LRU cache with 1, 2, ..., N ways would have had, from the stack distance monitor.
+ */
+std::vector<long> lru_hit_curve(const cache_stats& stats);
+
+/**
+ * The number of misses that an LRU cache with 1, 2, ..., N ways would have had, from the stack distance monitor.
+ */
+std::vector<long> lru_miss_curve(const cache_stats& stats);
+
 #endif
@@ -47,6 +47,18 @@ constexpr bool debug_print = true;
 constexpr bool debug_print = false;
 #endif
 
+#ifdef SET_WAY_HEATMAP
+constexpr bool record_heatmap = true;
+#else
+constexpr bool record_heatmap = false;
+#endif
+
+#ifdef LEAN_CACHE_BLOCKS
+constexpr bool lean_cache_blocks = true;
+#else
+constexpr bool lean_cache_blocks = false;
+#endif
+
 template <typename Extent>
 class address_slice;
 
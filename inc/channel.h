@@ -19,14 +19,16 @@
 
 #include <array>
 #include <cstdint>
-#include <deque>
 #include <limits>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "access_type.h"
 #include "address.h"
 #include "champsim.h"
+#include "util/ring_buffer.h"
+#include "util/small_vector.h"
 
 namespace champsim
 {
@@ -66,7 +68,7 @@ class channel
     uint64_t instr_id = 0;
     champsim::address ip{};
 
-    std::vector<uint64_t> instr_depend_on_me{};
+    champsim::small_vector<uint64_t, 4> instr_depend_on_me{};
   };
 
   struct response {
@@ -74,13 +76,75 @@ class channel
     champsim::address v_address{};
     champsim::address data{};
     uint32_t pf_metadata = 0;
-    std::vector<uint64_t> instr_depend_on_me{};
+    champsim::small_vector<uint64_t, 4> instr_depend_on_me{};
 
-    response(champsim::address addr, champsim::address v_addr, champsim::address data_, uint32_t pf_meta, std::vector<uint64_t> deps)
-        : address(addr), v_address(v_addr), data(data_), pf_metadata(pf_meta), instr_depend_on_me(deps)
+    response(champsim::address addr, champsim::address v_addr, champsim::address data_, uint32_t pf_meta, champsim::small_vector<uint64_t, 4> deps)
+        : address(addr), v_address(v_addr), data(data_), pf_metadata(pf_meta), instr_depend_on_me(std::move(deps))
     {
     }
-    explicit response(request req) : response(req.address, req.v_address, req.data, req.pf_metadata, req.instr_depend_on_me) {}
+    explicit response(request req) : response(req.address, req.v_address, req.data, req.pf_metadata, std::move(req.instr_depend_on_me)) {}
+  };
+
+  /**
+   * A queue of requests that also indexes its entries by block.
+   *
+   * Every entry is stamped with a sequence number, kept in a parallel buffer that stays sorted because entries are only appended. The
+   * index is an open-addressed table, sized with the queue, that maps each block to the number of its entries and the sequence number of
+   * the oldest one. check_collision() uses it to find the entry a packet merges with or forwards from without scanning the queue.
+   * Entries must not have their address changed while they are in the queue.
+   */
+  class request_queue : public champsim::ring_buffer<request>
+  {
+    using base_type = champsim::ring_buffer<request>;
+
+    struct index_slot {
+      uint64_t block = 0;
+      uint64_t oldest = 0;
+      std::size_t count = 0; // zero marks an empty slot
+    };
+
+    champsim::data::bits shamt{};
+    uint64_t next_seq = 0;
+    champsim::ring_buffer<uint64_t> seqs{};
+    std::vector<index_slot> slots{};
+    std::size_t num_blocks = 0;
+
+    [[nodiscard]] uint64_t key(champsim::address addr) const { return addr.slice_upper(shamt).to<uint64_t>(); }
+    [[nodiscard]] std::size_t home(uint64_t block) const;
+    [[nodiscard]] std::size_t find_slot(uint64_t block) const;
+    [[nodiscard]] std::size_t position_of(uint64_t seq) const;
+    void rehash(std::size_t num_slots);
+    void remove_slot(std::size_t pos);
+    void index_insert();
+    void index_erase(std::size_t idx);
+
+  public:
+    request_queue() = default;
+    explicit request_queue(champsim::data::bits index_shamt) : shamt(index_shamt) {}
+
+    void reserve(std::size_t new_capacity);
+
+    void push_back(const request& pkt);
+    void push_back(request&& pkt);
+    template <typename... Args>
+    request& emplace_back(Args&&... args);
+
+    void pop_front();
+    void pop_back();
+    void clear();
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+
+    /**
+     * The number of entries whose address falls in the same block as the given address.
+     */
+    [[nodiscard]] std::size_t block_count(champsim::address addr) const;
+
+    /**
+     * The oldest entry whose address falls in the same block as the given address, or end() if there is none.
+     */
+    [[nodiscard]] iterator find_first(champsim::address addr);
+    [[nodiscard]] const_iterator find_first(champsim::address addr) const;
   };
 
   template <typename R>
@@ -97,11 +161,15 @@ public:
   using request_type = request;
   using stats_type = cache_queue_stats;
 
-  std::deque<request_type> RQ{}, PQ{}, WQ{};
-  std::deque<response_type> returned{};
+  request_queue RQ{}, PQ{}, WQ{};
+  champsim::ring_buffer<response_type> returned{};
 
   stats_type sim_stats{}, roi_stats{};
 
+  // The number of accesses that each request on this channel stands for. A set-sampled cache raises this on its lower level, so that the
+  // memory controller can weight its statistics like the cache does.
+  uint32_t sample_weight = 1;
+
   channel() = default;
   channel(std::size_t rq_size, std::size_t pq_size, std::size_t wq_size, champsim::data::bits offset_bits, bool match_offset);
 
@@ -119,6 +187,14 @@ public:
 
   void check_collision();
 };
+
+template <typename... Args>
+auto channel::request_queue::emplace_back(Args&&... args) -> request&
+{
+  base_type::emplace_back(std::forward<Args>(args)...);
+  index_insert();
+  return back();
+}
 } // namespace champsim
 
 #endif
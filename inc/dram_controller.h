@@ -102,14 +102,15 @@ struct DRAM_CHANNEL final : public champsim::operable {
     uint8_t asid[2] = {std::numeric_limits<uint8_t>::max(), std::numeric_limits<uint8_t>::max()};
 
     uint32_t pf_metadata = 0;
+    uint32_t sample_weight = 1;
 
     champsim::address address{};
     champsim::address v_address{};
     champsim::address data{};
     champsim::chrono::clock::time_point ready_time = champsim::chrono::clock::time_point::max();
 
-    std::vector<uint64_t> instr_depend_on_me{};
-    std::vector<std::deque<response_type>*> to_return{};
+    champsim::small_vector<uint64_t, 4> instr_depend_on_me{};
+    champsim::small_vector<champsim::ring_buffer<response_type>*, 2> to_return{};
 
     explicit request_type(const typename champsim::channel::request_type& req);
   };
@@ -196,7 +197,7 @@ class MEMORY_CONTROLLER : public champsim::operable
 
   void initiate_requests();
   bool add_rq(const request_type& packet, champsim::channel* ul);
-  bool add_wq(const request_type& packet);
+  bool add_wq(const request_type& packet, champsim::channel* ul);
 
   const DRAM_ADDRESS_MAPPING address_mapping;
 
@@ -58,6 +58,13 @@ public:
     (*value_iter)++;
   }
 
+  void increment(key_type key, value_type amount)
+  {
+    allocate(key);
+    auto [key_iter, value_iter] = get_iter(key);
+    *value_iter += amount;
+  }
+
   void set(key_type key, value_type val)
   {
     allocate(key);
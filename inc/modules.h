@@ -20,6 +20,7 @@
 #include <cstdint>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "access_type.h"
 #include "address.h"
@@ -28,6 +29,18 @@
 
 class CACHE;
 class O3_CPU;
+namespace champsim
+{
+/**
+ * One candidate in a batch of prefetches, as passed to CACHE::prefetch_lines().
+ */
+struct prefetch_request {
+  champsim::address address;
+  bool fill_this_level = true;
+  uint32_t metadata = 0;
+};
+} // namespace champsim
+
 namespace champsim::modules
 {
 inline constexpr bool warn_if_any_missing = true;
@@ -103,6 +116,7 @@ struct prefetcher : public bound_to<CACHE> {
   explicit prefetcher(CACHE* cache) : bound_to<CACHE>(cache) {}
   bool prefetch_line(champsim::address pf_addr, bool fill_this_level, uint32_t prefetch_metadata) const;
   [[deprecated]] bool prefetch_line(uint64_t pf_addr, bool fill_this_level, uint32_t prefetch_metadata) const;
+  std::size_t prefetch_lines(const std::vector<champsim::prefetch_request>& requests) const;
 
   template <typename T, typename... Args>
   static auto initiailize_memory_impl(int) -> decltype(std::declval<T>().prefetcher_initialize(std::declval<Args>()...), std::true_type{});
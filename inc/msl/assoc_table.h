@@ -0,0 +1,305 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MSL_ASSOC_TABLE_H
+#define MSL_ASSOC_TABLE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace champsim::msl
+{
+/**
+ * Replacement policies for assoc_table.
+ *
+ * A policy keeps whatever per-way state it needs, indexed by the slot (set * ways + way) of the way. The table informs it of every fill and hit, and asks
+ * it for a victim only when every way of the set is valid.
+ */
+namespace table_policy
+{
+/**
+ * Evict the least recently used way.
+ */
+class lru
+{
+  std::vector<uint64_t> last_used;
+  uint64_t access_count = 0;
+
+public:
+  void reset(std::size_t slots) { last_used.assign(slots, 0); }
+  void fill(std::size_t slot) { last_used[slot] = ++access_count; }
+  void hit(std::size_t slot) { last_used[slot] = ++access_count; }
+
+  template <typename T>
+  std::size_t victim(std::size_t first_slot, std::size_t ways, const T*)
+  {
+    auto begin = std::next(std::cbegin(last_used), static_cast<std::ptrdiff_t>(first_slot));
+    return static_cast<std::size_t>(std::distance(begin, std::min_element(begin, std::next(begin, static_cast<std::ptrdiff_t>(ways)))));
+  }
+};
+
+/**
+ * Static re-reference interval prediction. Fills are predicted to be re-referenced in the distant future, and hits in the near-immediate future.
+ */
+template <unsigned BITS = 2>
+class srrip
+{
+  constexpr static uint8_t MAX_RRPV = (1u << BITS) - 1;
+  std::vector<uint8_t> rrpv;
+
+public:
+  void reset(std::size_t slots) { rrpv.assign(slots, MAX_RRPV); }
+  void fill(std::size_t slot) { rrpv[slot] = MAX_RRPV - 1; }
+  void hit(std::size_t slot) { rrpv[slot] = 0; }
+
+  template <typename T>
+  std::size_t victim(std::size_t first_slot, std::size_t ways, const T*)
+  {
+    auto begin = std::next(std::begin(rrpv), static_cast<std::ptrdiff_t>(first_slot));
+    auto end = std::next(begin, static_cast<std::ptrdiff_t>(ways));
+    auto oldest = std::max_element(begin, end);
+    std::for_each(begin, end, [age = MAX_RRPV - *oldest](auto& x) { x = static_cast<uint8_t>(x + age); });
+    return static_cast<std::size_t>(std::distance(begin, oldest));
+  }
+};
+
+/**
+ * Evict the way with the lowest priority, which is given when the way is filled. Ties are broken by recency: towards the least recently used way
+ * by default, or towards the most recently used one if EVICT_MRU is set.
+ */
+template <bool EVICT_MRU = false>
+class priority_lru
+{
+  struct state {
+    uint64_t last_used = 0;
+    uint8_t priority = 0;
+  };
+  std::vector<state> ways_state;
+  uint64_t access_count = 0;
+
+public:
+  void reset(std::size_t slots) { ways_state.assign(slots, state{}); }
+  void fill(std::size_t slot, uint8_t priority = 0) { ways_state[slot] = {++access_count, priority}; }
+  void hit(std::size_t slot) { ways_state[slot].last_used = ++access_count; }
+
+  template <typename T>
+  std::size_t victim(std::size_t first_slot, std::size_t ways, const T*)
+  {
+    auto begin = std::next(std::cbegin(ways_state), static_cast<std::ptrdiff_t>(first_slot));
+    auto end = std::next(begin, static_cast<std::ptrdiff_t>(ways));
+    auto chosen = std::min_element(begin, end, [](const state& x, const state& y) {
+      if (x.priority != y.priority)
+        return x.priority < y.priority;
+      return EVICT_MRU ? (x.last_used > y.last_used) : (x.last_used < y.last_used);
+    });
+    return static_cast<std::size_t>(std::distance(begin, chosen));
+  }
+};
+
+/**
+ * Evict the way whose entry has the smallest counter, as read by the projection. The counter lives in the entry, so the owner of the table updates
+ * it directly. Ties go to the lowest way.
+ */
+template <typename Proj>
+class min_counter
+{
+  Proj projection;
+
+public:
+  min_counter() = default;
+  explicit min_counter(Proj proj) : projection(proj) {}
+
+  void reset(std::size_t) {}
+  void fill(std::size_t) {}
+  void hit(std::size_t) {}
+
+  template <typename T>
+  std::size_t victim(std::size_t, std::size_t ways, const T* set_data)
+  {
+    auto chosen = std::min_element(set_data, set_data + ways, [proj = projection](const T& x, const T& y) { return proj(x) < proj(y); });
+    return static_cast<std::size_t>(std::distance(set_data, chosen));
+  }
+};
+} // namespace table_policy
+
+/**
+ * A set-associative table of values of type T, keyed by 64-bit integers.
+ *
+ * The key selects the set by its remainder modulo the number of sets, and the quotient is the tag, so that any number of sets is allowed. The tags of a
+ * set are stored contiguously, biased by one so that zero marks an invalid way, and the tag search is a branch-free scan that compilers vectorize. The
+ * values are stored in a parallel array, and the replacement policy keeps its own state.
+ */
+template <typename T, typename Policy = table_policy::lru>
+class assoc_table
+{
+public:
+  using value_type = T;
+  using policy_type = Policy;
+
+  struct entry {
+    uint64_t key;
+    value_type data;
+  };
+
+private:
+  constexpr static uint64_t INVALID_TAG = 0;
+
+  std::size_t NUM_SET;
+  std::size_t NUM_WAY;
+  std::vector<uint64_t> tags;
+  std::vector<value_type> values;
+  policy_type policy;
+
+  [[nodiscard]] std::size_t set_of(uint64_t key) const { return static_cast<std::size_t>(key % NUM_SET); }
+  [[nodiscard]] uint64_t stored_tag(uint64_t key) const { return key / NUM_SET + 1; }
+  [[nodiscard]] uint64_t key_of(std::size_t slot) const { return (tags[slot] - 1) * NUM_SET + slot / NUM_WAY; }
+
+  // The lowest way of the set whose stored tag matches, or NUM_WAY if there is none
+  [[nodiscard]] std::size_t find_way(std::size_t set, uint64_t tag) const
+  {
+    const uint64_t* set_tags = std::data(tags) + set * NUM_WAY;
+    std::size_t way = NUM_WAY;
+    for (std::size_t i = NUM_WAY; i-- > 0;)
+      way = (set_tags[i] == tag) ? i : way;
+    return way;
+  }
+
+  [[nodiscard]] std::optional<std::size_t> find_slot(uint64_t key) const
+  {
+    auto set = set_of(key);
+    auto way = find_way(set, stored_tag(key));
+    if (way == NUM_WAY)
+      return std::nullopt;
+    return set * NUM_WAY + way;
+  }
+
+public:
+  assoc_table(std::size_t sets, std::size_t ways, Policy policy_ = {})
+      : NUM_SET(sets), NUM_WAY(ways), tags(sets * ways, INVALID_TAG), values(sets * ways), policy(std::move(policy_))
+  {
+    if (sets == 0)
+      throw std::range_error{"Sets is not positive"};
+    if (ways == 0)
+      throw std::range_error{"Ways is not positive"};
+    policy.reset(sets * ways);
+  }
+
+  [[nodiscard]] std::size_t sets() const { return NUM_SET; }
+  [[nodiscard]] std::size_t ways() const { return NUM_WAY; }
+
+  /**
+   * The value for the key, or nullptr if it is not present. This does not update the replacement state.
+   */
+  [[nodiscard]] value_type* find(uint64_t key)
+  {
+    auto slot = find_slot(key);
+    return slot.has_value() ? &values[slot.value()] : nullptr;
+  }
+
+  [[nodiscard]] const value_type* find(uint64_t key) const
+  {
+    auto slot = find_slot(key);
+    return slot.has_value() ? &values[slot.value()] : nullptr;
+  }
+
+  /**
+   * Inform the replacement policy of a hit on the key, if it is present. Returns whether it was present.
+   */
+  bool touch(uint64_t key)
+  {
+    auto slot = find_slot(key);
+    if (slot.has_value())
+      policy.hit(slot.value());
+    return slot.has_value();
+  }
+
+  /**
+   * Insert or replace the value for the key. The remaining arguments are passed to the policy's fill.
+   *
+   * Returns the entry that previously occupied the way: the old value of the key if it was present, or the evicted victim if the set was full.
+   */
+  template <typename... FillArgs>
+  std::optional<entry> insert(uint64_t key, const value_type& data, FillArgs&&... fill_args)
+  {
+    auto set = set_of(key);
+    auto way = find_way(set, stored_tag(key));
+    if (way == NUM_WAY)
+      way = find_way(set, INVALID_TAG);
+    if (way == NUM_WAY)
+      way = policy.victim(set * NUM_WAY, NUM_WAY, std::data(values) + set * NUM_WAY);
+
+    auto slot = set * NUM_WAY + way;
+    std::optional<entry> previous;
+    if (tags[slot] != INVALID_TAG)
+      previous = entry{key_of(slot), std::move(values[slot])};
+
+    tags[slot] = stored_tag(key);
+    values[slot] = data;
+    policy.fill(slot, std::forward<FillArgs>(fill_args)...);
+    return previous;
+  }
+
+  /**
+   * Remove the key. Returns its value, if it was present.
+   */
+  std::optional<value_type> erase(uint64_t key)
+  {
+    auto slot = find_slot(key);
+    if (!slot.has_value())
+      return std::nullopt;
+    tags[slot.value()] = INVALID_TAG;
+    return std::exchange(values[slot.value()], value_type{});
+  }
+
+  /**
+   * Remove every entry.
+   */
+  void invalidate_all()
+  {
+    std::fill(std::begin(tags), std::end(tags), INVALID_TAG);
+    std::fill(std::begin(values), std::end(values), value_type{});
+    policy.reset(std::size(tags));
+  }
+
+  /**
+   * Call func(key, value) for every valid entry, in set-major order.
+   */
+  template <typename F>
+  void for_each(F&& func)
+  {
+    for (std::size_t slot = 0; slot < std::size(tags); ++slot) {
+      if (tags[slot] != INVALID_TAG)
+        func(key_of(slot), values[slot]);
+    }
+  }
+
+  template <typename F>
+  void for_each(F&& func) const
+  {
+    for (std::size_t slot = 0; slot < std::size(tags); ++slot) {
+      if (tags[slot] != INVALID_TAG)
+        func(key_of(slot), std::as_const(values[slot]));
+    }
+  }
+};
+} // namespace champsim::msl
+
+#endif
@@ -38,6 +38,16 @@ struct phase_info {
   std::vector<std::string> trace_names;
 };
 
+/**
+ * Directories holding one snapshot file per cache, named after the cache.
+ * If load_from is not empty, the caches are loaded from it before the first phase. If save_to is not empty, the caches are saved to it after each warmup
+ * phase.
+ */
+struct cache_snapshot_paths {
+  std::string load_from;
+  std::string save_to;
+};
+
 struct phase_stats {
   std::string name;
   std::vector<std::string> trace_names;
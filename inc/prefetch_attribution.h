@@ -0,0 +1,102 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PREFETCH_ATTRIBUTION_H
+#define PREFETCH_ATTRIBUTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * The prefetch outcomes attributed to one IP.
+ *
+ * As a trigger, the IP is charged with the prefetches issued while the prefetcher handled its accesses, and with whether they were useful, late, or
+ * useless. As a demand, it is charged with its misses and with the prefetched blocks that it hit, so that its coverage is covered / (covered + misses).
+ */
+struct ip_prefetch_stats {
+  uint64_t ip = 0;
+  uint64_t volume = 0; // every event counted for the IP, plus the volume of the IP it displaced
+  uint64_t issued = 0;
+  uint64_t useful = 0;
+  uint64_t late = 0;
+  uint64_t useless = 0;
+  uint64_t misses = 0;
+  uint64_t covered = 0;
+};
+
+/**
+ * Bounded per-IP prefetch statistics, kept for the IPs with the most events.
+ *
+ * The table follows the space-saving algorithm: an IP that is not tracked when the table is full displaces the IP with the least volume, and inherits
+ * that volume. The heaviest IPs are therefore always tracked, and their counts are exact from the time they entered the table. The entries are kept in a
+ * min-heap on volume, so that the lightest is found without a scan.
+ *
+ * Prefetches carry a compact id of their trigger's entry. If the entry is reassigned to another IP before the prefetch resolves, the id is stale and
+ * the outcome is not counted.
+ */
+class prefetch_attribution
+{
+public:
+  using id_type = uint64_t;
+  constexpr static id_type NONE = 0;
+
+  explicit prefetch_attribution(std::size_t capacity);
+
+  /**
+   * Count a prefetch issued for the trigger IP, and return the id to carry with it.
+   */
+  id_type issue(uint64_t trigger_ip, uint64_t weight);
+  void useful(id_type trigger, uint64_t weight);
+  void late(id_type trigger, uint64_t weight);
+  void useless(id_type trigger, uint64_t weight);
+
+  void miss(uint64_t demand_ip, uint64_t weight);
+  void covered(uint64_t demand_ip, uint64_t weight);
+
+  /**
+   * Forget every IP. Ids issued before this are stale afterwards.
+   */
+  void clear();
+
+  /**
+   * The tracked IPs, from the greatest volume to the least.
+   */
+  [[nodiscard]] std::vector<ip_prefetch_stats> top() const;
+
+private:
+  struct entry {
+    ip_prefetch_stats stats{};
+    uint32_t generation = 0;
+    bool used = false;
+    std::size_t heap_pos = 0;
+  };
+
+  std::vector<entry> entries;
+  std::vector<std::size_t> heap; // indices of the entries, unused ones first, then by increasing volume
+  std::unordered_map<uint64_t, std::size_t> index;
+
+  std::size_t track(uint64_t ip, uint64_t weight);
+  void add_volume(std::size_t idx, uint64_t weight);
+  void sift_down(std::size_t pos);
+  [[nodiscard]] ip_prefetch_stats* resolve(id_type id, uint64_t weight);
+};
+} // namespace champsim
+
+#endif
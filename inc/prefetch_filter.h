@@ -0,0 +1,49 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PREFETCH_FILTER_H
+#define PREFETCH_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * A hashed bitset of the blocks that recently had a prefetch or a miss issued by a cache.
+ *
+ * Each block sets two bits. If either bit is clear, the cache skips searching its queues for a duplicate. Bits are cleared when a block is filled or
+ * evicted, which may also clear a bit of another pending block. A clear bit therefore does not prove that a block is not pending, but a block it
+ * misses only costs a duplicate request, which the MSHR merges.
+ */
+class prefetch_filter
+{
+  std::vector<bool> bits;
+
+  [[nodiscard]] std::pair<std::size_t, std::size_t> indices(uint64_t block) const;
+
+public:
+  explicit prefetch_filter(std::size_t size);
+
+  void insert(uint64_t block);
+  void erase(uint64_t block);
+  [[nodiscard]] bool maybe_contains(uint64_t block) const;
+};
+} // namespace champsim
+
+#endif
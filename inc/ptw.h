@@ -55,8 +55,8 @@ class PageTableWalker : public champsim::operable
     champsim::address v_address{};
     champsim::waitable<champsim::address> data{};
 
-    std::vector<uint64_t> instr_depend_on_me{};
-    std::vector<std::deque<response_type>*> to_return{};
+    champsim::small_vector<uint64_t, 4> instr_depend_on_me{};
+    champsim::small_vector<champsim::ring_buffer<response_type>*, 2> to_return{};
 
     uint32_t pf_metadata = 0;
     uint32_t cpu = std::numeric_limits<uint32_t>::max();
@@ -0,0 +1,75 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SET_WAY_HEATMAP_H
+#define SET_WAY_HEATMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * Counts accesses, fills, and evictions for each way of each set of a set-associative structure, over fixed intervals.
+ *
+ * Each set has one extra column past the last way, which counts the accesses that missed and the fills that bypassed. Callers can then select the
+ * column arithmetically, without branching on the outcome.
+ */
+class set_way_heatmap
+{
+  std::size_t columns = 0;
+  std::vector<uint64_t> accesses{};
+  std::vector<uint64_t> fills{};
+  std::vector<uint64_t> evictions{};
+  long interval = 0;
+  std::size_t phase_ends = 0;
+
+  [[nodiscard]] std::size_t index(long set, long way) const { return static_cast<std::size_t>(set) * columns + static_cast<std::size_t>(way); }
+
+public:
+  constexpr static long INTERVAL_CYCLES = 1000000;
+
+  set_way_heatmap() = default;
+  set_way_heatmap(std::size_t sets, std::size_t ways);
+
+  void access(long set, long way) { ++accesses[index(set, way)]; }
+  void fill(long set, long way, bool evicted)
+  {
+    ++fills[index(set, way)];
+    evictions[index(set, way)] += evicted;
+  }
+
+  /**
+   * Append the nonzero counters of the current interval to a CSV file, and start a new interval.
+   * The file is truncated when the first interval is written.
+   */
+  void write_interval(const std::string& file_name);
+
+  /**
+   * Note that a core has finished the current phase. The interval is written once, when the last of num_cpus cores finishes.
+   */
+  void end_phase(const std::string& file_name, std::size_t num_cpus);
+
+  /**
+   * Start counting the cores that finish a new phase.
+   */
+  void begin_phase() { phase_ends = 0; }
+};
+} // namespace champsim
+
+#endif
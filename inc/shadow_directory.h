@@ -0,0 +1,62 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SHADOW_DIRECTORY_H
+#define SHADOW_DIRECTORY_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "msl/assoc_table.h"
+
+namespace champsim
+{
+/**
+ * The outcomes of the prefetches requested by one shadow prefetcher.
+ *
+ * A shadow prefetch is useful if a demand access finds its block in the shadow directory, and useless if the block is evicted from there first. Demand
+ * accesses that miss, or that hit a block brought in by the cache's own prefetchers, are counted in demand_misses, and covered if a shadow prefetch
+ * was useful to them. Requests for blocks that are resident in the cache or already in the shadow directory are counted as redundant.
+ */
+struct shadow_prefetch_stats {
+  uint64_t issued = 0;
+  uint64_t redundant = 0;
+  uint64_t useful = 0;
+  uint64_t useless = 0;
+  uint64_t covered = 0;
+  uint64_t demand_misses = 0;
+};
+
+/**
+ * The blocks prefetched by a shadow prefetcher, which never enter the cache.
+ *
+ * A block leaves the directory when a demand access finds it, or when it is the least recently prefetched block of its set and another is prefetched.
+ */
+class shadow_directory
+{
+  msl::assoc_table<uint32_t> blocks; // the statistical weight of each prefetch
+
+public:
+  shadow_prefetch_stats stats{};
+
+  shadow_directory(std::size_t sets, std::size_t ways);
+
+  void prefetch(uint64_t block, bool resident, uint32_t weight);
+  void access(uint64_t block, bool demand_miss, uint32_t weight);
+};
+} // namespace champsim
+
+#endif
@@ -0,0 +1,94 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SHADOW_PREFETCHER_H
+#define SHADOW_PREFETCHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "cache.h"
+#include "modules.h"
+
+namespace champsim
+{
+/**
+ * Runs the prefetcher P in observe-only mode.
+ *
+ * P receives the same calls as the cache's other prefetchers, but every prefetch it requests is recorded in a shadow directory of the cache instead of
+ * being issued, so it does not affect timing or the contents of the cache. Its metadata is not returned to the cache. The outcomes are reported with
+ * the cache's statistics, in the order that the shadow prefetchers were configured.
+ */
+template <typename P>
+class shadow_prefetcher : public champsim::modules::prefetcher
+{
+  CACHE::prefetcher_module_model<P> model;
+  std::size_t directory;
+
+  template <typename F>
+  void diverted(F&& func)
+  {
+    intern_->divert_prefetches(directory);
+    std::forward<F>(func)();
+    intern_->divert_prefetches(std::nullopt);
+  }
+
+public:
+  explicit shadow_prefetcher(CACHE* cache) : prefetcher(cache), model(cache), directory(cache->add_shadow_directory()) {}
+
+  void bind(CACHE* cache)
+  {
+    prefetcher::bind(cache);
+    model.bind(cache);
+  }
+
+  void prefetcher_initialize()
+  {
+    diverted([&] { model.impl_prefetcher_initialize(); });
+  }
+
+  uint32_t prefetcher_cache_operate(champsim::address addr, champsim::address ip, bool cache_hit, bool useful_prefetch, access_type type,
+                                    uint32_t metadata_in, std::string latepf)
+  {
+    diverted([&] { (void)model.impl_prefetcher_cache_operate(addr, ip, cache_hit, useful_prefetch, type, metadata_in, std::move(latepf)); });
+    return 0; // the cache combines the metadata of its prefetchers by exclusive-or
+  }
+
+  uint32_t prefetcher_cache_fill(champsim::address addr, long set, long way, bool prefetch, champsim::address evicted_addr, uint32_t metadata_in)
+  {
+    diverted([&] { (void)model.impl_prefetcher_cache_fill(addr, set, way, prefetch, evicted_addr, metadata_in); });
+    return 0;
+  }
+
+  void prefetcher_cycle_operate()
+  {
+    diverted([&] { model.impl_prefetcher_cycle_operate(); });
+  }
+
+  void prefetcher_branch_operate(champsim::address ip, uint8_t branch_type, champsim::address branch_target)
+  {
+    diverted([&] { model.impl_prefetcher_branch_operate(ip, branch_type, branch_target); });
+  }
+
+  void prefetcher_final_stats() { model.impl_prefetcher_final_stats(); }
+
+  void set_llc_reference(CACHE* llc_cache) { model.impl_setup_prefetcher_llc_connection(llc_cache); }
+};
+} // namespace champsim
+
+#endif
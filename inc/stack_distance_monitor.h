@@ -0,0 +1,51 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STACK_DISTANCE_MONITOR_H
+#define STACK_DISTANCE_MONITOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace champsim
+{
+/**
+ * Tracks the LRU stack position of each access to a set-associative structure (Mattson's stack algorithm).
+ *
+ * Because LRU has the inclusion property, an access that is found at stack position p would hit in any cache of the same number of sets with more than p
+ * ways. A histogram of positions therefore gives the hit and miss counts for every associativity from 1 to the monitored number of ways in a single run.
+ */
+class stack_distance_monitor
+{
+  std::size_t num_ways;
+  std::vector<uint64_t> stacks; // one stack per set, most recently used first
+  std::vector<std::size_t> depths;
+
+public:
+  stack_distance_monitor(std::size_t sets, std::size_t ways);
+
+  /**
+   * Record an access to the block in the given set, and move it to the top of the stack.
+   * Returns the stack position at which the block was found, or ways() if it was not found.
+   */
+  std::size_t access(long set, uint64_t block);
+
+  [[nodiscard]] std::size_t ways() const;
+};
+} // namespace champsim
+
+#endif
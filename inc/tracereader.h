@@ -17,6 +17,7 @@
 #ifndef TRACEREADER_H
 #define TRACEREADER_H
 
+#include <algorithm>
 #include <cstring>
 #include <deque>
 #include <memory>
@@ -26,6 +27,7 @@
 
 #include "instruction.h"
 #include "util/detect.h"
+#include "util/ring_buffer.h"
 
 namespace champsim
 {
@@ -58,22 +60,75 @@ class tracereader
 
   std::unique_ptr<reader_concept> pimpl_;
 
+  // Instructions that have been decoded for peek(), but not yet read
+  champsim::ring_buffer<ooo_model_instr> lookahead_buffer{};
+  std::size_t lookahead_limit = 0;
+
+  ooo_model_instr decode()
+  {
+    auto retval = (*pimpl_)();
+    retval.instr_id = instr_unique_id++;
+    return retval;
+  }
+
 public:
   template <typename T, std::enable_if_t<!std::is_same_v<tracereader, T>, bool> = true>
   tracereader(T&& val) : pimpl_(std::make_unique<reader_model<T>>(std::forward<T>(val)))
   {
   }
 
-  auto operator()()
+  ooo_model_instr operator()()
   {
-    auto retval = (*pimpl_)();
-    retval.instr_id = instr_unique_id++;
+    if (std::empty(lookahead_buffer))
+      return decode();
+
+    auto retval = lookahead_buffer.front();
+    lookahead_buffer.pop_front();
     return retval;
   }
 
-  [[nodiscard]] auto eof() const { return pimpl_->eof(); }
+  [[nodiscard]] auto eof() const { return std::empty(lookahead_buffer) && pimpl_->eof(); }
+
+  /**
+   * Allow peek() to look at least this many instructions ahead. The instructions are decoded into a buffer of this size as they are peeked at.
+   */
+  void reserve_lookahead(std::size_t instructions)
+  {
+    lookahead_limit = std::max(lookahead_limit, instructions);
+    lookahead_buffer.reserve(lookahead_limit);
+  }
+
+  [[nodiscard]] std::size_t lookahead() const { return lookahead_limit; }
+
+  /**
+   * The instruction that the given number of reads from now will return, or nullptr if that is beyond the lookahead or the end of the trace.
+   * Instructions are given their IDs when they are decoded, so a peeked instruction has the ID that it will be read with. The pointer is valid until
+   * the instruction is read.
+   */
+  const ooo_model_instr* peek(std::size_t distance)
+  {
+    if (distance >= lookahead_limit)
+      return nullptr;
+    while (std::size(lookahead_buffer) <= distance && !pimpl_->eof())
+      lookahead_buffer.push_back(decode());
+    return distance < std::size(lookahead_buffer) ? &lookahead_buffer[distance] : nullptr;
+  }
 };
 
+/**
+ * The traces that the cores are reading, for modules that look into the future of a core's instruction stream.
+ * A trace is attached to its core at the beginning of each phase.
+ */
+namespace lookahead
+{
+void attach(uint32_t cpu, tracereader* trace);
+
+/**
+ * The trace that the core is reading, or nullptr if none is attached.
+ */
+[[nodiscard]] tracereader* trace(uint32_t cpu);
+} // namespace lookahead
+
 template <typename T, typename F>
 class bulk_tracereader
 {
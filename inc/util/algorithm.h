@@ -18,6 +18,7 @@
 #define UTIL_ALGORITHM_H
 
 #include <algorithm>
+#include <iterator>
 
 #include "bandwidth.h"
 #include "util/span.h"
@@ -47,6 +48,27 @@ long int transform_while_n(R& queue, Output out, bandwidth sz, F&& test_func, G&
   queue.erase(begin, end);
   return retval;
 }
+
+/**
+ * Merge the sorted range in source into the sorted container dest, as if by std::set_union.
+ * The common cases, where one side is empty, do not build a temporary.
+ */
+template <typename R>
+void set_union_into(R& dest, const R& source)
+{
+  if (std::empty(source)) {
+    return;
+  }
+  if (std::empty(dest)) {
+    dest = source;
+    return;
+  }
+
+  R merged{};
+  merged.reserve(std::size(dest) + std::size(source));
+  std::set_union(std::begin(dest), std::end(dest), std::begin(source), std::end(source), std::back_inserter(merged));
+  dest = std::move(merged);
+}
 } // namespace champsim
 
 #endif
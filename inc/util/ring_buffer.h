@@ -0,0 +1,323 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_RING_BUFFER_H
+#define UTIL_RING_BUFFER_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace champsim
+{
+/**
+ * A double-ended queue stored in a single contiguous, power-of-two sized allocation.
+ *
+ * The simulator's queues all have a configured maximum size, so once the buffer has reached that size it never allocates again.
+ * If a queue is unbounded, the buffer doubles when it fills, so the capacity is only a hint.
+ *
+ * Iterators refer to a logical position in the queue, so they are not invalidated by push_back(), even if the buffer grows.
+ * Erasing from the middle moves whichever side of the erased range is shorter.
+ */
+template <typename T>
+class ring_buffer
+{
+  using alloc_type = std::allocator<T>;
+  using alloc_traits = std::allocator_traits<alloc_type>;
+
+  alloc_type alloc{};
+  T* storage = nullptr;
+  std::size_t m_capacity = 0; // always zero or a power of two
+  std::size_t head = 0;
+  std::size_t m_size = 0;
+
+  [[nodiscard]] std::size_t physical(std::size_t idx) const { return (head + idx) & (m_capacity - 1); }
+  [[nodiscard]] T& slot(std::size_t idx) { return storage[physical(idx)]; }
+  [[nodiscard]] const T& slot(std::size_t idx) const { return storage[physical(idx)]; }
+
+  void destroy(std::size_t idx) { alloc_traits::destroy(alloc, &slot(idx)); }
+
+  void relocate(std::size_t new_capacity)
+  {
+    T* new_storage = alloc_traits::allocate(alloc, new_capacity);
+    for (std::size_t i = 0; i < m_size; ++i) {
+      alloc_traits::construct(alloc, new_storage + i, std::move_if_noexcept(slot(i)));
+      destroy(i);
+    }
+    if (storage != nullptr) {
+      alloc_traits::deallocate(alloc, storage, m_capacity);
+    }
+    storage = new_storage;
+    m_capacity = new_capacity;
+    head = 0;
+  }
+
+  void grow_if_full()
+  {
+    if (m_size == m_capacity) {
+      relocate(std::max<std::size_t>(2 * m_capacity, 4));
+    }
+  }
+
+  template <bool Const>
+  class iterator_base
+  {
+    using container_type = std::conditional_t<Const, const ring_buffer, ring_buffer>;
+    container_type* buf = nullptr;
+    std::ptrdiff_t idx = 0;
+
+    friend class ring_buffer;
+    friend class iterator_base<!Const>;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    iterator_base() = default;
+    iterator_base(container_type* buf_, std::ptrdiff_t idx_) : buf(buf_), idx(idx_) {}
+
+    template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+    iterator_base(const iterator_base<OtherConst>& other) : buf(other.buf), idx(other.idx) // NOLINT(google-explicit-constructor)
+    {
+    }
+
+    [[nodiscard]] reference operator*() const { return buf->slot(static_cast<std::size_t>(idx)); }
+    [[nodiscard]] pointer operator->() const { return &(**this); }
+    [[nodiscard]] reference operator[](difference_type n) const { return *(*this + n); }
+
+    iterator_base& operator++()
+    {
+      ++idx;
+      return *this;
+    }
+    iterator_base operator++(int)
+    {
+      auto retval = *this;
+      ++(*this);
+      return retval;
+    }
+    iterator_base& operator--()
+    {
+      --idx;
+      return *this;
+    }
+    iterator_base operator--(int)
+    {
+      auto retval = *this;
+      --(*this);
+      return retval;
+    }
+    iterator_base& operator+=(difference_type n)
+    {
+      idx += n;
+      return *this;
+    }
+    iterator_base& operator-=(difference_type n)
+    {
+      idx -= n;
+      return *this;
+    }
+
+    friend iterator_base operator+(iterator_base it, difference_type n) { return it += n; }
+    friend iterator_base operator+(difference_type n, iterator_base it) { return it += n; }
+    friend iterator_base operator-(iterator_base it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const iterator_base& lhs, const iterator_base& rhs) { return lhs.idx - rhs.idx; }
+
+    friend bool operator==(const iterator_base& lhs, const iterator_base& rhs) { return lhs.idx == rhs.idx; }
+    friend bool operator!=(const iterator_base& lhs, const iterator_base& rhs) { return lhs.idx != rhs.idx; }
+    friend bool operator<(const iterator_base& lhs, const iterator_base& rhs) { return lhs.idx < rhs.idx; }
+    friend bool operator>(const iterator_base& lhs, const iterator_base& rhs) { return lhs.idx > rhs.idx; }
+    friend bool operator<=(const iterator_base& lhs, const iterator_base& rhs) { return lhs.idx <= rhs.idx; }
+    friend bool operator>=(const iterator_base& lhs, const iterator_base& rhs) { return lhs.idx >= rhs.idx; }
+  };
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using iterator = iterator_base<false>;
+  using const_iterator = iterator_base<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  ring_buffer() = default;
+  explicit ring_buffer(std::size_t capacity_hint) { reserve(capacity_hint); }
+
+  ring_buffer(const ring_buffer& other)
+  {
+    reserve(std::size(other));
+    std::copy(std::begin(other), std::end(other), std::back_inserter(*this));
+  }
+
+  ring_buffer(ring_buffer&& other) noexcept
+      : storage(std::exchange(other.storage, nullptr)), m_capacity(std::exchange(other.m_capacity, 0)), head(std::exchange(other.head, 0)),
+        m_size(std::exchange(other.m_size, 0))
+  {
+  }
+
+  ring_buffer& operator=(const ring_buffer& other)
+  {
+    if (this != &other) {
+      clear();
+      reserve(std::size(other));
+      std::copy(std::begin(other), std::end(other), std::back_inserter(*this));
+    }
+    return *this;
+  }
+
+  ring_buffer& operator=(ring_buffer&& other) noexcept
+  {
+    ring_buffer tmp{std::move(other)};
+    swap(tmp);
+    return *this;
+  }
+
+  ~ring_buffer()
+  {
+    clear();
+    if (storage != nullptr) {
+      alloc_traits::deallocate(alloc, storage, m_capacity);
+    }
+  }
+
+  void swap(ring_buffer& other) noexcept
+  {
+    std::swap(storage, other.storage);
+    std::swap(m_capacity, other.m_capacity);
+    std::swap(head, other.head);
+    std::swap(m_size, other.m_size);
+  }
+
+  /**
+   * Ensure that the buffer can hold at least new_capacity elements without allocating.
+   */
+  void reserve(std::size_t new_capacity)
+  {
+    if (new_capacity > m_capacity) {
+      std::size_t rounded = 1;
+      while (rounded < new_capacity) {
+        rounded <<= 1;
+      }
+      relocate(rounded);
+    }
+  }
+
+  [[nodiscard]] iterator begin() { return iterator{this, 0}; }
+  [[nodiscard]] iterator end() { return iterator{this, static_cast<difference_type>(m_size)}; }
+  [[nodiscard]] const_iterator begin() const { return const_iterator{this, 0}; }
+  [[nodiscard]] const_iterator end() const { return const_iterator{this, static_cast<difference_type>(m_size)}; }
+  [[nodiscard]] const_iterator cbegin() const { return begin(); }
+  [[nodiscard]] const_iterator cend() const { return end(); }
+  [[nodiscard]] reverse_iterator rbegin() { return reverse_iterator{end()}; }
+  [[nodiscard]] reverse_iterator rend() { return reverse_iterator{begin()}; }
+  [[nodiscard]] const_reverse_iterator rbegin() const { return const_reverse_iterator{end()}; }
+  [[nodiscard]] const_reverse_iterator rend() const { return const_reverse_iterator{begin()}; }
+
+  [[nodiscard]] std::size_t size() const { return m_size; }
+  [[nodiscard]] std::size_t capacity() const { return m_capacity; }
+  [[nodiscard]] bool empty() const { return m_size == 0; }
+
+  [[nodiscard]] reference operator[](std::size_t idx) { return slot(idx); }
+  [[nodiscard]] const_reference operator[](std::size_t idx) const { return slot(idx); }
+
+  [[nodiscard]] reference front() { return slot(0); }
+  [[nodiscard]] const_reference front() const { return slot(0); }
+  [[nodiscard]] reference back() { return slot(m_size - 1); }
+  [[nodiscard]] const_reference back() const { return slot(m_size - 1); }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args)
+  {
+    grow_if_full();
+    alloc_traits::construct(alloc, &slot(m_size), std::forward<Args>(args)...);
+    ++m_size;
+    return back();
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  void pop_front()
+  {
+    assert(!empty());
+    destroy(0);
+    head = physical(1);
+    --m_size;
+  }
+
+  void pop_back()
+  {
+    assert(!empty());
+    destroy(m_size - 1);
+    --m_size;
+  }
+
+  void clear()
+  {
+    for (std::size_t i = 0; i < m_size; ++i) {
+      destroy(i);
+    }
+    head = 0;
+    m_size = 0;
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    const auto pos = static_cast<std::size_t>(first.idx);
+    const auto count = static_cast<std::size_t>(last.idx - first.idx);
+    const auto after = m_size - pos - count;
+
+    if (count == 0) {
+      return iterator{this, first.idx};
+    }
+
+    if (pos < after) {
+      // Fewer elements before the range: shift them toward the back, then drop the front
+      for (std::size_t i = pos; i > 0; --i) {
+        slot(i - 1 + count) = std::move(slot(i - 1));
+      }
+      for (std::size_t i = 0; i < count; ++i) {
+        destroy(i);
+      }
+      head = physical(count);
+    } else {
+      // Fewer elements after the range: shift them toward the front, then drop the back
+      for (std::size_t i = pos; i < pos + after; ++i) {
+        slot(i) = std::move(slot(i + count));
+      }
+      for (std::size_t i = pos + after; i < m_size; ++i) {
+        destroy(i);
+      }
+    }
+    m_size -= count;
+
+    return iterator{this, first.idx};
+  }
+};
+} // namespace champsim
+
+#endif
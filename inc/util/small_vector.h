@@ -0,0 +1,206 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL_SMALL_VECTOR_H
+#define UTIL_SMALL_VECTOR_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+namespace champsim
+{
+/**
+ * A contiguous container that holds up to N elements inline, and only allocates on the heap if it grows past that.
+ *
+ * This is intended for the short lists that travel with packets (dependent instructions, return queues), which almost always hold
+ * one or two elements. Copying a list that fits inline does not allocate.
+ *
+ * Only trivially copyable element types are supported.
+ */
+template <typename T, std::size_t N>
+class small_vector
+{
+  static_assert(std::is_trivially_copyable_v<T>, "small_vector only supports trivially copyable types");
+  static_assert(N > 0, "small_vector must have some inline capacity");
+
+  std::size_t m_size = 0;
+  std::size_t m_capacity = N;
+  std::array<T, N> inline_storage{};
+  std::unique_ptr<T[]> heap_storage{};
+
+  void grow(std::size_t new_capacity)
+  {
+    auto new_storage = std::make_unique<T[]>(new_capacity);
+    std::copy(begin(), end(), new_storage.get());
+    heap_storage = std::move(new_storage);
+    m_capacity = new_capacity;
+  }
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  small_vector() = default;
+  small_vector(std::initializer_list<T> init) { assign(std::begin(init), std::end(init)); }
+
+  template <typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+  small_vector(InputIt first, InputIt last)
+  {
+    assign(first, last);
+  }
+
+  small_vector(const small_vector& other) { assign(std::begin(other), std::end(other)); }
+
+  small_vector(small_vector&& other) noexcept { *this = std::move(other); }
+
+  small_vector& operator=(const small_vector& other)
+  {
+    if (this != &other) {
+      assign(std::begin(other), std::end(other));
+    }
+    return *this;
+  }
+
+  small_vector& operator=(small_vector&& other) noexcept
+  {
+    if (this != &other) {
+      if (other.heap_storage) {
+        heap_storage = std::move(other.heap_storage);
+        m_capacity = other.m_capacity;
+      } else {
+        heap_storage.reset();
+        m_capacity = N;
+        std::copy(std::begin(other), std::end(other), std::begin(inline_storage));
+      }
+      m_size = other.m_size;
+
+      other.m_size = 0;
+      other.m_capacity = N;
+    }
+    return *this;
+  }
+
+  small_vector& operator=(std::initializer_list<T> init)
+  {
+    assign(std::begin(init), std::end(init));
+    return *this;
+  }
+
+  template <typename InputIt>
+  void assign(InputIt first, InputIt last)
+  {
+    clear();
+    std::copy(first, last, std::back_inserter(*this));
+  }
+
+  [[nodiscard]] T* data() { return heap_storage ? heap_storage.get() : inline_storage.data(); }
+  [[nodiscard]] const T* data() const { return heap_storage ? heap_storage.get() : inline_storage.data(); }
+
+  [[nodiscard]] iterator begin() { return data(); }
+  [[nodiscard]] iterator end() { return data() + m_size; }
+  [[nodiscard]] const_iterator begin() const { return data(); }
+  [[nodiscard]] const_iterator end() const { return data() + m_size; }
+  [[nodiscard]] const_iterator cbegin() const { return begin(); }
+  [[nodiscard]] const_iterator cend() const { return end(); }
+
+  [[nodiscard]] std::size_t size() const { return m_size; }
+  [[nodiscard]] std::size_t capacity() const { return m_capacity; }
+  [[nodiscard]] bool empty() const { return m_size == 0; }
+
+  /**
+   * Returns true if the elements currently live in the inline storage.
+   */
+  [[nodiscard]] bool is_inline() const { return !heap_storage; }
+
+  [[nodiscard]] reference operator[](std::size_t idx) { return data()[idx]; }
+  [[nodiscard]] const_reference operator[](std::size_t idx) const { return data()[idx]; }
+
+  [[nodiscard]] reference front() { return *begin(); }
+  [[nodiscard]] const_reference front() const { return *begin(); }
+  [[nodiscard]] reference back() { return *std::prev(end()); }
+  [[nodiscard]] const_reference back() const { return *std::prev(end()); }
+
+  void reserve(std::size_t new_capacity)
+  {
+    if (new_capacity > m_capacity) {
+      grow(new_capacity);
+    }
+  }
+
+  void push_back(const T& value)
+  {
+    if (m_size == m_capacity) {
+      auto copied = value; // value may alias an element of this container
+      grow(2 * m_capacity);
+      data()[m_size++] = copied;
+    } else {
+      data()[m_size++] = value;
+    }
+  }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args)
+  {
+    push_back(T{std::forward<Args>(args)...});
+    return back();
+  }
+
+  void pop_back()
+  {
+    assert(m_size > 0);
+    --m_size;
+  }
+
+  iterator insert(const_iterator pos, const T& value)
+  {
+    auto idx = std::distance(cbegin(), pos);
+    push_back(value);
+    std::rotate(std::next(begin(), idx), std::prev(end()), end());
+    return std::next(begin(), idx);
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, std::next(pos)); }
+
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    auto idx = std::distance(cbegin(), first);
+    auto count = std::distance(first, last);
+    auto new_end = std::copy(std::next(begin(), idx + count), end(), std::next(begin(), idx));
+    m_size = static_cast<std::size_t>(std::distance(begin(), new_end));
+    return std::next(begin(), idx);
+  }
+
+  void clear() { m_size = 0; }
+
+  friend bool operator==(const small_vector& lhs, const small_vector& rhs) { return std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs), std::end(rhs)); }
+  friend bool operator!=(const small_vector& lhs, const small_vector& rhs) { return !(lhs == rhs); }
+};
+} // namespace champsim
+
+#endif
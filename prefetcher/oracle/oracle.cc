@@ -0,0 +1,66 @@
+#include "oracle.h"
+
+#include <fmt/core.h>
+
+#include "cache.h"
+#include "tracereader.h"
+
+oracle::oracle(CACHE* cache) : oracle(cache, DEFAULT_DISTANCE) {}
+
+oracle::oracle(CACHE* cache, std::size_t distance_) : prefetcher(cache), distance(distance_) {}
+
+void oracle::prefetcher_initialize()
+{
+  if (!intern_->virtual_prefetch)
+    fmt::print("[{}] WARNING: the oracle prefetcher reads virtual addresses from the trace, but the cache does not prefetch virtually\n", intern_->NAME);
+}
+
+uint32_t oracle::prefetcher_cache_operate(champsim::address addr, champsim::address ip, uint8_t cache_hit, bool useful_prefetch, access_type type,
+                                          uint32_t metadata_in, std::string latepf)
+{
+  return metadata_in;
+}
+
+uint32_t oracle::prefetcher_cache_fill(champsim::address addr, long set, long way, uint8_t prefetch, champsim::address evicted_addr, uint32_t metadata_in)
+{
+  return metadata_in;
+}
+
+void oracle::prefetcher_cycle_operate()
+{
+  auto* trace = champsim::lookahead::trace(intern_->cpu);
+  if (trace == nullptr)
+    return;
+  trace->reserve_lookahead(distance);
+
+  const auto* front = trace->peek(0);
+  if (front == nullptr)
+    return;
+
+  // Instructions that the core has already read are no longer in the future
+  if (next_instr_id < front->instr_id) {
+    next_instr_id = front->instr_id;
+    next_operand = 0;
+  }
+
+  for (auto instr = trace->peek(next_instr_id - front->instr_id); instr != nullptr; instr = trace->peek(next_instr_id - front->instr_id)) {
+    const auto operands = std::size(instr->source_memory) + std::size(instr->destination_memory);
+    for (; next_operand < operands; ++next_operand) {
+      auto addr = next_operand < std::size(instr->source_memory) ? instr->source_memory[next_operand]
+                                                                 : instr->destination_memory[next_operand - std::size(instr->source_memory)];
+      if (champsim::block_number{addr} == last_block)
+        continue;
+
+      // If the prefetch queue is full, resume from this operand on the next cycle
+      if (!intern_->prefetch_line(addr, true, 0))
+        return;
+      last_block = champsim::block_number{addr};
+      ++issued;
+    }
+
+    ++next_instr_id;
+    next_operand = 0;
+  }
+}
+
+void oracle::prefetcher_final_stats() { fmt::print("{} ORACLE distance: {} issued: {}\n", intern_->NAME, distance, issued); }
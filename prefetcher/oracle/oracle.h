@@ -0,0 +1,40 @@
+#ifndef PREFETCHER_ORACLE_H
+#define PREFETCHER_ORACLE_H
+
+#include <cstdint>
+#include <string>
+
+#include "address.h"
+#include "modules.h"
+
+/**
+ * A prefetcher with perfect knowledge of the future, to measure how much coverage and timeliness other prefetchers leave on the table.
+ *
+ * Every cycle, it looks up to a fixed number of instructions past the point where the core is reading its trace, and prefetches every block that those
+ * instructions load or store, in program order, as soon as they come within that distance. The addresses in the trace are virtual, so the cache must be
+ * configured with virtual_prefetch.
+ */
+class oracle : public champsim::modules::prefetcher
+{
+public:
+  constexpr static std::size_t DEFAULT_DISTANCE = 256;
+
+  explicit oracle(CACHE* cache);
+  oracle(CACHE* cache, std::size_t distance);
+
+  void prefetcher_initialize();
+  uint32_t prefetcher_cache_operate(champsim::address addr, champsim::address ip, uint8_t cache_hit, bool useful_prefetch, access_type type,
+                                    uint32_t metadata_in, std::string latepf);
+  uint32_t prefetcher_cache_fill(champsim::address addr, long set, long way, uint8_t prefetch, champsim::address evicted_addr, uint32_t metadata_in);
+  void prefetcher_cycle_operate();
+  void prefetcher_final_stats();
+
+private:
+  std::size_t distance;
+  uint64_t next_instr_id = 0;   // the first instruction whose blocks have not all been prefetched
+  std::size_t next_operand = 0; // the first of its memory operands that has not been prefetched
+  champsim::block_number last_block{};
+  uint64_t issued = 0;
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "event_log.h"
+
+#include <iterator>
+#include <fmt/core.h>
+
+auto prophet::late_prefetch_detail(std::string_view latepf) -> event_detail
+{
+  if (latepf == "MSHR")
+    return event_detail::MSHR;
+  if (latepf == "L2PQ")
+    return event_detail::L2PQ;
+  if (latepf == "L3PQ")
+    return event_detail::L3PQ;
+  return event_detail::NONE;
+}
+
+prophet::event_log::event_log(std::size_t buffer_bytes) : capacity(buffer_bytes)
+{
+  filling.reserve(capacity);
+  flushing.reserve(capacity);
+}
+
+prophet::event_log::~event_log() { close(); }
+
+bool prophet::event_log::open(const std::string& file_name)
+{
+  close();
+
+  file = ::gzopen(file_name.c_str(), "wb");
+  if (file == nullptr) {
+    fmt::print(stderr, "[prophet_profile] WARNING: cannot open {} for the event log\n", file_name);
+    return false;
+  }
+
+  closing = false;
+  num_events = 0;
+  append(std::data(MAGIC), std::size(MAGIC));
+  writer = std::thread{&event_log::write_loop, this};
+  return true;
+}
+
+template <typename It>
+void prophet::event_log::record_range(event_record rec, It triggers_begin, It triggers_end)
+{
+  if (file == nullptr)
+    return;
+
+  rec.trigger_count = static_cast<uint32_t>(std::distance(triggers_begin, triggers_end));
+  append(&rec, sizeof(rec));
+  for (; triggers_begin != triggers_end; ++triggers_begin) {
+    uint64_t trigger = *triggers_begin;
+    append(&trigger, sizeof(trigger));
+  }
+  ++num_events;
+}
+
+void prophet::event_log::record(event_record rec, const std::set<uint64_t>& triggers) { record_range(rec, std::begin(triggers), std::end(triggers)); }
+
+void prophet::event_log::record(event_record rec, const uint64_t* triggers_begin, const uint64_t* triggers_end)
+{
+  record_range(rec, triggers_begin, triggers_end);
+}
+
+void prophet::event_log::close()
+{
+  if (file == nullptr)
+    return;
+
+  hand_off();
+  {
+    std::lock_guard guard{lock};
+    closing = true;
+  }
+  changed.notify_all();
+  writer.join();
+
+  ::gzclose(file);
+  file = nullptr;
+}
+
+void prophet::event_log::append(const void* bytes, std::size_t size)
+{
+  auto begin = static_cast<const char*>(bytes);
+  filling.insert(std::end(filling), begin, begin + size);
+  if (std::size(filling) >= capacity) {
+    hand_off();
+  }
+}
+
+void prophet::event_log::hand_off()
+{
+  if (std::empty(filling))
+    return;
+
+  std::unique_lock guard{lock};
+  changed.wait(guard, [this] { return !flush_pending; });
+  std::swap(filling, flushing);
+  flush_pending = true;
+  guard.unlock();
+  changed.notify_all();
+}
+
+void prophet::event_log::write_loop()
+{
+  std::unique_lock guard{lock};
+  while (true) {
+    changed.wait(guard, [this] { return flush_pending || closing; });
+    if (!flush_pending)
+      return;
+
+    // The buffer being flushed is not touched by the recording thread until flush_pending is cleared
+    guard.unlock();
+    ::gzwrite(file, std::data(flushing), static_cast<unsigned>(std::size(flushing)));
+    flushing.clear();
+    guard.lock();
+
+    flush_pending = false;
+    changed.notify_all();
+  }
+}
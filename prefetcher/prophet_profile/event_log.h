@@ -0,0 +1,100 @@
+#ifndef PROPHET_EVENT_LOG_H
+#define PROPHET_EVENT_LOG_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+
+namespace prophet
+{
+enum class event_type : uint8_t { MISS, HIT, ADD, EVICT, ISSUE };
+
+// Qualifies the event: where a late prefetch was found for MISS, why an entry left the table for EVICT, and which table issued for ISSUE
+enum class event_detail : uint8_t { NONE, MSHR, L2PQ, L3PQ, CAPACITY, CONFLICT, MT, MRB };
+
+/**
+ * One fixed-size record in the event log. The trigger_count trigger blocks of the record follow it in the file, as little-endian 64-bit integers.
+ *
+ * The fields are used as follows:
+ *   MISS, HIT:  addr is the accessed block, ip the accessing IP, and other the last block accessed by that IP
+ *   ADD, EVICT: addr is the trigger block, and other the correlated block
+ *   ISSUE:      ip is the triggering IP, addr the block that was looked up, and other the block that was issued
+ */
+struct event_record {
+  uint64_t cycle = 0;
+  uint64_t ip = 0;
+  uint64_t addr = 0;
+  uint64_t other = 0;
+  uint32_t trigger_count = 0;
+  event_type type = event_type::MISS;
+  event_detail detail = event_detail::NONE;
+  uint16_t reserved = 0;
+};
+static_assert(sizeof(event_record) == 40, "The reader in expr/utils/event_log.py depends on this layout");
+
+/**
+ * The detail of a MISS, from the late prefetch string that the cache passes to its prefetchers.
+ */
+event_detail late_prefetch_detail(std::string_view latepf);
+
+/**
+ * Writes event records to a gzip-compressed file.
+ *
+ * Records are appended to a fixed-size buffer. When it fills, it is handed to a background thread that compresses and writes it, while recording
+ * continues into a second buffer. If the writer falls behind, recording waits for it, so memory use is bounded by the two buffers.
+ */
+class event_log
+{
+public:
+  constexpr static std::string_view MAGIC{"PPEVLOG1"};
+
+  explicit event_log(std::size_t buffer_bytes = std::size_t{1} << 20);
+  ~event_log();
+
+  event_log(const event_log&) = delete;
+  event_log& operator=(const event_log&) = delete;
+
+  /**
+   * Begin writing to the given file. Returns false, and records nothing, if the file cannot be opened.
+   */
+  bool open(const std::string& file_name);
+
+  void record(event_record rec, const std::set<uint64_t>& triggers = {});
+  void record(event_record rec, const uint64_t* triggers_begin, const uint64_t* triggers_end);
+
+  /**
+   * Write out every buffered record and close the file.
+   */
+  void close();
+
+  [[nodiscard]] uint64_t events() const { return num_events; }
+
+private:
+  std::size_t capacity;
+  std::vector<char> filling;
+  std::vector<char> flushing;
+  uint64_t num_events = 0;
+
+  gzFile file = nullptr;
+  std::thread writer;
+  std::mutex lock;
+  std::condition_variable changed;
+  bool flush_pending = false;
+  bool closing = false;
+
+  template <typename It>
+  void record_range(event_record rec, It triggers_begin, It triggers_end);
+  void append(const void* bytes, std::size_t size);
+  void hand_off();
+  void write_loop();
+};
+} // namespace prophet
+
+#endif
@@ -0,0 +1,73 @@
+#include "hints.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fmt/core.h>
+
+prophet::hint_table::~hint_table() { close(); }
+
+void prophet::hint_table::open(const std::string& file_name)
+{
+  close();
+
+  int fd = ::open(file_name.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error{fmt::format("Cannot open the hint profile {}", file_name)};
+
+  struct stat file_stat {};
+  if (::fstat(fd, &file_stat) != 0) {
+    ::close(fd);
+    throw std::runtime_error{fmt::format("Cannot read the size of the hint profile {}", file_name)};
+  }
+
+  const auto file_size = static_cast<std::size_t>(file_stat.st_size);
+  const auto header_size = std::size(MAGIC) + sizeof(uint64_t);
+  if (file_size < header_size) {
+    ::close(fd);
+    throw std::runtime_error{fmt::format("{} is not a hint profile", file_name)};
+  }
+
+  void* mapped = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd); // the mapping holds its own reference to the file
+  if (mapped == MAP_FAILED)
+    throw std::runtime_error{fmt::format("Cannot map the hint profile {}", file_name)};
+
+  auto bytes = static_cast<const char*>(mapped);
+  uint64_t count = 0;
+  std::memcpy(&count, bytes + std::size(MAGIC), sizeof(count));
+  if (std::string_view{bytes, std::size(MAGIC)} != MAGIC || count > (file_size - header_size) / sizeof(hint)) {
+    ::munmap(mapped, file_size);
+    throw std::runtime_error{fmt::format("{} is not a hint profile", file_name)};
+  }
+
+  mapping = mapped;
+  mapping_size = file_size;
+  records = reinterpret_cast<const hint*>(bytes + header_size); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  num_records = static_cast<std::size_t>(count);
+}
+
+void prophet::hint_table::close()
+{
+  if (mapping == nullptr)
+    return;
+
+  ::munmap(mapping, mapping_size);
+  mapping = nullptr;
+  mapping_size = 0;
+  records = nullptr;
+  num_records = 0;
+}
+
+auto prophet::hint_table::find(uint64_t ip) const -> const hint*
+{
+  auto end = records + num_records;
+  auto found = std::lower_bound(records, end, ip, [](const hint& rec, uint64_t key) { return rec.ip < key; });
+  if (found == end || found->ip != ip)
+    return nullptr;
+  return found;
+}
@@ -0,0 +1,64 @@
+#ifndef PROPHET_HINTS_H
+#define PROPHET_HINTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace prophet
+{
+/**
+ * The hint that a profile gives for one IP.
+ */
+struct hint {
+  uint64_t ip = 0;
+  int32_t priority = 0; // the replacement priority of metadata inserted by the IP
+  uint32_t flags = 0;
+
+  constexpr static uint32_t INSERT = 1; // the IP may insert metadata
+
+  [[nodiscard]] bool allows_insert() const { return (flags & INSERT) != 0; }
+};
+static_assert(sizeof(hint) == 16, "The converter in expr/utils/convert_hints.py depends on this layout");
+
+/**
+ * A read-only profile of per-IP hints, mapped directly from a file.
+ *
+ * The file is the 8-byte magic, a little-endian 64-bit record count, and then the records, sorted by IP. Lookups are a binary search over the
+ * mapping, so opening is constant-time and concurrent simulations share the page-cached file.
+ */
+class hint_table
+{
+public:
+  constexpr static std::string_view MAGIC{"PPHINT01"};
+
+  hint_table() = default;
+  ~hint_table();
+
+  hint_table(const hint_table&) = delete;
+  hint_table& operator=(const hint_table&) = delete;
+
+  /**
+   * Map the given file. Throws std::runtime_error if it cannot be mapped or is not a hint profile.
+   */
+  void open(const std::string& file_name);
+  void close();
+
+  [[nodiscard]] bool is_open() const { return mapping != nullptr; }
+  [[nodiscard]] std::size_t size() const { return num_records; }
+
+  /**
+   * The hint for the IP, or nullptr if the profile has none.
+   */
+  [[nodiscard]] const hint* find(uint64_t ip) const;
+
+private:
+  void* mapping = nullptr;
+  std::size_t mapping_size = 0;
+  const hint* records = nullptr;
+  std::size_t num_records = 0;
+};
+} // namespace prophet
+
+#endif
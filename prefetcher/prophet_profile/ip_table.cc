@@ -0,0 +1,158 @@
+#include "ip_table.h"
+
+#include <cassert>
+#include <tuple>
+
+prophet::ip_table::ip_table(std::size_t expected_ips)
+{
+  std::size_t capacity = 16;
+  while (capacity * 3 < expected_ips * 4)
+    capacity *= 2;
+  keys.resize(capacity);
+  slots.resize(capacity, EMPTY);
+  records.reserve(expected_ips);
+}
+
+std::size_t prophet::ip_table::home(uint64_t ip) const
+{
+  // splitmix64 finalizer
+  ip ^= ip >> 30;
+  ip *= 0xbf58476d1ce4e5b9ull;
+  ip ^= ip >> 27;
+  ip *= 0x94d049bb133111ebull;
+  ip ^= ip >> 31;
+  return static_cast<std::size_t>(ip) & (std::size(slots) - 1);
+}
+
+prophet::ip_record* prophet::ip_table::find(uint64_t ip)
+{
+  const auto mask = std::size(slots) - 1;
+  for (auto pos = home(ip); slots[pos] != EMPTY; pos = (pos + 1) & mask) {
+    if (keys[pos] == ip)
+      return &records[slots[pos]];
+  }
+  return nullptr;
+}
+
+prophet::ip_record& prophet::ip_table::operator[](uint64_t ip)
+{
+  const auto mask = std::size(slots) - 1;
+  auto pos = home(ip);
+  for (; slots[pos] != EMPTY; pos = (pos + 1) & mask) {
+    if (keys[pos] == ip)
+      return records[slots[pos]];
+  }
+
+  if ((std::size(records) + 1) * 4 > std::size(slots) * 3) {
+    grow();
+    return operator[](ip);
+  }
+
+  keys[pos] = ip;
+  slots[pos] = static_cast<uint32_t>(std::size(records));
+  auto& rec = records.emplace_back();
+  rec.ip = ip;
+  return rec;
+}
+
+void prophet::ip_table::grow()
+{
+  std::vector<uint64_t> old_keys(2 * std::size(keys));
+  std::vector<uint32_t> old_slots(2 * std::size(slots), EMPTY);
+  std::swap(keys, old_keys);
+  std::swap(slots, old_slots);
+
+  const auto mask = std::size(slots) - 1;
+  for (std::size_t i = 0; i < std::size(old_slots); ++i) {
+    if (old_slots[i] == EMPTY)
+      continue;
+    auto pos = home(old_keys[i]);
+    while (slots[pos] != EMPTY)
+      pos = (pos + 1) & mask;
+    keys[pos] = old_keys[i];
+    slots[pos] = old_slots[i];
+  }
+}
+
+TrainEntry& prophet::ip_table::train(ip_record& rec)
+{
+  if (!rec.training) {
+    rec.training = true;
+    rec.train = TrainEntry();
+    heap.push_back(static_cast<uint32_t>(&rec - std::data(records)));
+    rec.heap_pos = std::size(heap) - 1;
+    sift_up(rec.heap_pos);
+  }
+  return rec.train;
+}
+
+void prophet::ip_table::add_solved(ip_record& rec)
+{
+  train(rec).solved += 1;
+  sift_down(rec.heap_pos);
+}
+
+prophet::ip_record& prophet::ip_table::least_solved()
+{
+  assert(!std::empty(heap));
+  return records[heap.front()];
+}
+
+void prophet::ip_table::retire(ip_record& rec)
+{
+  if (!rec.training)
+    return;
+
+  auto pos = rec.heap_pos;
+  rec.training = false;
+  rec.train = TrainEntry();
+
+  auto last = heap.back();
+  heap.pop_back();
+  if (pos < std::size(heap)) {
+    heap_place(pos, last);
+    sift_up(pos);
+    sift_down(records[last].heap_pos);
+  }
+}
+
+bool prophet::ip_table::heap_less(uint32_t lhs, uint32_t rhs) const
+{
+  return std::tie(records[lhs].train.solved, records[lhs].ip) < std::tie(records[rhs].train.solved, records[rhs].ip);
+}
+
+void prophet::ip_table::heap_place(std::size_t pos, uint32_t idx)
+{
+  heap[pos] = idx;
+  records[idx].heap_pos = pos;
+}
+
+void prophet::ip_table::sift_up(std::size_t pos)
+{
+  auto idx = heap[pos];
+  while (pos > 0) {
+    auto parent = (pos - 1) / 2;
+    if (!heap_less(idx, heap[parent]))
+      break;
+    heap_place(pos, heap[parent]);
+    pos = parent;
+  }
+  heap_place(pos, idx);
+}
+
+void prophet::ip_table::sift_down(std::size_t pos)
+{
+  auto idx = heap[pos];
+  while (true) {
+    auto child = 2 * pos + 1;
+    if (child >= std::size(heap))
+      break;
+    if (child + 1 < std::size(heap) && heap_less(heap[child + 1], heap[child]))
+      ++child;
+    if (!heap_less(heap[child], idx))
+      break;
+    heap_place(pos, heap[child]);
+    pos = child;
+  }
+  heap_place(pos, idx);
+}
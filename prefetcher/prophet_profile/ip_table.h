@@ -0,0 +1,92 @@
+#ifndef PROPHET_IP_TABLE_H
+#define PROPHET_IP_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct TrainEntry
+{
+    TrainEntry()
+    {
+        issued = 0;
+        solved = 0;
+        meta_inserted = 0;
+        meta_used = 0;
+        protect = true;
+    }
+    uint32_t issued;
+    uint32_t solved;
+    uint32_t meta_inserted;
+    uint32_t meta_used;
+    bool protect;
+};
+
+namespace prophet
+{
+/**
+ * Everything prophet_profile tracks for one IP: the last block it accessed, the number of misses it caused, and its training entry, if it has one.
+ */
+struct ip_record {
+  uint64_t ip = 0;
+  uint64_t last_addr = 0;
+  uint32_t misses = 0;
+  bool training = false;
+  std::size_t heap_pos = 0;
+  TrainEntry train;
+};
+
+/**
+ * A flat hash table of ip_records, with an indexed min-heap over the records that are training.
+ *
+ * Records are never removed, so the hash is insert-only and stores indices into one dense vector of records. The heap is ordered by the number of solved
+ * prefetches, then by IP, so that least_solved() names the same victim that a linear scan of an IP-ordered map would.
+ *
+ * References to records are invalidated when a new IP is added.
+ */
+class ip_table
+{
+public:
+  explicit ip_table(std::size_t expected_ips = 1024);
+
+  /**
+   * The record of the IP, which is created if the IP has not been seen before.
+   */
+  ip_record& operator[](uint64_t ip);
+  [[nodiscard]] ip_record* find(uint64_t ip);
+
+  [[nodiscard]] std::size_t size() const { return std::size(records); }
+  [[nodiscard]] std::size_t training_size() const { return std::size(heap); }
+
+  /**
+   * The training entry of the record, which begins training if it was not already.
+   * The number of solved prefetches must only be changed through add_solved().
+   */
+  TrainEntry& train(ip_record& rec);
+  void add_solved(ip_record& rec);
+
+  /**
+   * The training record with the fewest solved prefetches. The table must have at least one training record.
+   */
+  [[nodiscard]] ip_record& least_solved();
+  void retire(ip_record& rec);
+
+private:
+  constexpr static uint32_t EMPTY = UINT32_MAX;
+
+  std::vector<uint64_t> keys;
+  std::vector<uint32_t> slots; // the index into records of the key in the same position, or EMPTY
+  std::vector<ip_record> records;
+  std::vector<uint32_t> heap;
+
+  [[nodiscard]] std::size_t home(uint64_t ip) const;
+  void grow();
+
+  [[nodiscard]] bool heap_less(uint32_t lhs, uint32_t rhs) const;
+  void heap_place(std::size_t pos, uint32_t idx);
+  void sift_up(std::size_t pos);
+  void sift_down(std::size_t pos);
+};
+} // namespace prophet
+
+#endif
@@ -19,51 +19,45 @@ void prophet_profile::invoke_prefetcher(uint64_t ip, uint64_t addr, uint8_t cach
     }
 
     uint64_t block_addr = addr >> LOG2_BLOCK_SIZE;
-    if (!cache_hit || prefetched_addr.find(addr >> LOG2_BLOCK_SIZE) != prefetched_addr.end())
+    prophet::ip_record *rec = &ipTable[ip];
+    auto prefetched = prefetched_addr.find(block_addr);
+    if (!cache_hit || prefetched != prefetched_addr.end())
     {
         allMisses += 1;
-        if (missTable.find(ip) == missTable.end())
-            missTable[ip] = 1;
-        else
-            missTable[ip] += 1;
+        rec->misses += 1;
     }
 
-    if (trainTable.find(ip) == trainTable.end())
+    if (!rec->training)
     {
-        if (trainTable.size() < 128)
+        if (ipTable.training_size() < TRAIN_TABLE_SIZE)
         {
-            trainTable[ip] = TrainEntry();
+            ipTable.train(*rec);
         }
         else
         {
-            std::map<uint64_t, TrainEntry>::iterator minPointer = trainTable.begin();
-            for (std::map<uint64_t, TrainEntry>::iterator it = trainTable.begin(); it != trainTable.end(); ++it)
-            {
-                if (it->second.solved < minPointer->second.solved)
-                {
-                    minPointer = it;
-                }
-            }
-            if (!minPointer->second.protect)
+            prophet::ip_record &victim = ipTable.least_solved();
+            if (!victim.train.protect)
             {
-                trainTable.erase(minPointer);
-                trainTable[ip] = TrainEntry();
+                ipTable.retire(victim);
+                ipTable.train(*rec);
             }
             else
             {
-                minPointer->second.protect = false;
+                victim.train.protect = false;
             }
         }
     }
     else
     {
-        if (cache_hit && prefetched_addr.find(block_addr) != prefetched_addr.end()){
-            trainTable[prefetched_addr[block_addr]].solved += 1;
-            prefetched_addr.erase(block_addr);
+        if (cache_hit && prefetched != prefetched_addr.end()){
+            ipTable.add_solved(ipTable[prefetched->second]);
+            prefetched_addr.erase(prefetched);
+            rec = ipTable.find(ip);
         }
     }
 
-    if (enableInsertFilter && !inTraining && profileInsertTable.find(ip) == profileInsertTable.end())
+    const prophet::hint *hint = hints->find(ip);
+    if (enableInsertFilter && !inTraining && (hint == nullptr || !hint->allows_insert()))
         return;
 
     global_timestamp++;
@@ -73,7 +67,7 @@ void prophet_profile::invoke_prefetcher(uint64_t ip, uint64_t addr, uint8_t cach
     ProphetMetaTableEntry *metadata = metaTable->find(block_addr);
     ProphetMRBTableEntry *reuseData = mrbTable->find(block_addr);
 
-    uint64_t lastAddr = pcTable.find(ip) != pcTable.end() ? pcTable[ip] : 0;
+    uint64_t lastAddr = rec->last_addr;
     if (lastAddr == block_addr)
         return;
     if (reuseData)
@@ -111,7 +105,7 @@ void prophet_profile::invoke_prefetcher(uint64_t ip, uint64_t addr, uint8_t cach
     {
         // parent->prefetch_line(ip, addr, prefetch_address, FILL_L2, 0);
         prefetched_addr[prefetch_address >> LOG2_BLOCK_SIZE] = ip;
-        trainTable[ip].issued += 1;
+        ipTable.train(*rec).issued += 1;
     }
     
     // 3.update
@@ -144,7 +138,7 @@ void prophet_profile::invoke_prefetcher(uint64_t ip, uint64_t addr, uint8_t cach
 
 
                 // victim buffer logic
-                if (profileReplTable[ip] > 1)
+                if (hint != nullptr && hint->priority > 1)
                 {
                     ProphetMRBTableEntry *victimMeta = mrbTable->find(lastAddr);
                     if (!victimMeta)
@@ -171,20 +165,20 @@ void prophet_profile::invoke_prefetcher(uint64_t ip, uint64_t addr, uint8_t cach
         else
         {
             ProphetMetaTableEntry temp_entry(block_addr);
-            if (!inTraining && enablePGLRU && profileReplTable.find(ip) != profileReplTable.end())
-                metaTable->insert(lastAddr,temp_entry, profileReplTable[ip]);
+            if (!inTraining && enablePGLRU && hint != nullptr)
+                metaTable->insert(lastAddr,temp_entry, static_cast<uint8_t>(hint->priority));
             else{
                 if (!metaTable->insert(lastAddr,temp_entry, 1)) // lyq: profile中，prio = 0 ？
                 {
                     numEntriesinTable++;
                 }
             }
-            trainTable[ip].meta_inserted++;
+            ipTable.train(*rec).meta_inserted++;
         }
     }
 
-    // 3.2 update the pcTable
-    pcTable[ip] = block_addr;
+    // 3.2 update the last addr of the PC
+    rec->last_addr = block_addr;
 }
 
 int prophet_profile::issue_metatable(ProphetMetaTable *metaTable, uint64_t lookup, uint64_t pc, std::vector<uint64_t> &addresses)
@@ -201,9 +195,7 @@ int prophet_profile::issue_metatable(ProphetMetaTable *metaTable, uint64_t looku
             if (!isAlreadyInQueue(addresses, candidate->correlatedAddr << LOG2_BLOCK_SIZE))
             {
                 addresses.push_back(candidate->correlatedAddr << LOG2_BLOCK_SIZE);
-                std::ostringstream oss;         
-                oss<<std::dec<<parent->current_cycle()<< " ISSUE MT "<< std::hex<<pc<<" "<< (lookup)<<" " << (candidate->correlatedAddr);
-                logs.push_back(oss.str());    
+                events->record({parent->current_cycle(), pc, lookup, candidate->correlatedAddr, 0, prophet::event_type::ISSUE, prophet::event_detail::MT});
                 issued++;
             }
             lookup = candidate->correlatedAddr;
@@ -226,9 +218,7 @@ int prophet_profile::issue_mrbtable(ProphetMRBTable *mrbTable, uint64_t lookup,
             lookup = candidate->correlatedAddr;
             if (!isAlreadyInQueue(addresses, candidate->correlatedAddr << LOG2_BLOCK_SIZE))
             {
-                std::ostringstream oss;         
-                oss<<std::dec<<parent->current_cycle()<< " ISSUE MRB "<< std::hex<<pc<<" "<< (lookup)<<" " << (candidate->correlatedAddr);
-                logs.push_back(oss.str());    
+                events->record({parent->current_cycle(), pc, lookup, candidate->correlatedAddr, 0, prophet::event_type::ISSUE, prophet::event_detail::MRB});
                 addresses.push_back(candidate->correlatedAddr << LOG2_BLOCK_SIZE);
                 issued++;
             }
@@ -250,15 +240,10 @@ uint32_t prophet_profile::prefetcher_cache_operate(champsim::address addr, champ
             champsim::block_number pf_addr{addr};
             //std::ofstream ofs(out_file, std::ios::app);  // append mode
             uint64_t last_addr = get_last(ip.to<uint64_t>());
-            std::set<uint64_t> triggers = get_triggers(addr.to<uint64_t>() >> LOG2_BLOCK_SIZE);
+            prophet::trigger_view triggers = get_triggers(addr.to<uint64_t>() >> LOG2_BLOCK_SIZE);
             
-            std::ostringstream oss;         
-            oss<<std::dec<<parent->current_cycle()<< " MISS "<<latepf<<" "<<std::hex<<pf_addr<<" "<<ip<<" "<<last_addr;
-
-            for(uint64_t t:triggers) {
-                oss << " " << t;
-            }
-            logs.push_back(oss.str());
+            events->record({parent->current_cycle(), ip.to<uint64_t>(), pf_addr.to<uint64_t>(), last_addr, 0, prophet::event_type::MISS, prophet::late_prefetch_detail(latepf)},
+                           std::begin(triggers), std::end(triggers));
 
             //ofs.close();
         }
@@ -267,15 +252,9 @@ uint32_t prophet_profile::prefetcher_cache_operate(champsim::address addr, champ
             champsim::block_number pf_addr{addr};
             //std::ofstream ofs(out_file, std::ios::app);  // append mode
             uint64_t last_addr = get_last(ip.to<uint64_t>());
-            std::set<uint64_t> triggers = get_triggers(addr.to<uint64_t>() >> LOG2_BLOCK_SIZE);
+            prophet::trigger_view triggers = get_triggers(addr.to<uint64_t>() >> LOG2_BLOCK_SIZE);
             
-            std::ostringstream oss;         
-            oss<<std::dec<<parent->current_cycle()<< " HIT "<<std::hex<<pf_addr<<" "<<ip<<" "<<last_addr;
-
-            for(uint64_t t:triggers) {
-                oss << " " << t;
-            }
-            logs.push_back(oss.str());
+            events->record({parent->current_cycle(), ip.to<uint64_t>(), pf_addr.to<uint64_t>(), last_addr, 0, prophet::event_type::HIT}, std::begin(triggers), std::end(triggers));
 
             //ofs.close();
         }
@@ -288,13 +267,12 @@ uint32_t prophet_profile::prefetcher_cache_operate(champsim::address addr, champ
     
     if (prefetch_candidate.size()==0) return metadata_in;
 
-    for (int i = 0; i<prefetch_candidate.size(); i++) {
-      uint64_t p_addr = prefetch_candidate[i];
-      
+    std::vector<champsim::prefetch_request> batch;
+    for (uint64_t p_addr : prefetch_candidate) {
       if (p_addr == 0) break;
-      champsim::address prefetch_addr{p_addr};
-      const bool success = prefetch_line(prefetch_addr, true, 0);
+      batch.push_back({champsim::address{p_addr}, true, 0});
     }
+    prefetch_lines(batch);
   return metadata_in;
 }
 
@@ -304,51 +282,31 @@ uint32_t prophet_profile::prefetcher_cache_fill(champsim::address addr, long set
 }
 
 void prophet_profile::prefetcher_final_stats() {
-    std::ofstream ofs(out_file);
-    std::cout <<"hi!"<<logs.size()<<std::endl;
-    for(std::string s : logs) {
-        ofs << s << "\n";
-    }
-    ofs.close();
+    events->close();
+    std::cout << "prophet_profile: " << events->events() << " events written to " << out_file << std::endl;
  }
 
 void prophet_profile::prefetcher_cycle_operate() {}
 
 bool ProphetMetaTable::insert(uint64_t key, const ProphetMetaTableEntry &data, uint8_t priority)
 {
-    reverse_metatable[data.correlatedAddr].insert(key);
+    if (track_triggers)
+        reverse_metatable.insert(data.correlatedAddr, key);
 
-    
-    Entry victim_entry = Super::insert(key, data);
-    Super::set_mru(key);
-    uint64_t index = key % this->num_sets;
-    uint64_t tag = key / this->num_sets;
-    int way = this->cams[index][tag];
-    priority_pgo[index][way] = priority;
-    bool ret = false;
-    if(victim_entry.valid) {
-        std::ostringstream oss1;
-        std::string reason;
-        //std::cout << "hola" << std::endl;
-        reverse_metatable[victim_entry.data.correlatedAddr].erase(victim_entry.key);
-        
-        if (victim_entry.tag != tag) {
-            reason = "CAPACITY";
-        } else {
-            reason = "CONFLICT";
-        }
-        oss1<<std::dec<<pp->parent->current_cycle()<< " EVICT "<<reason<<" "<<std::hex<<victim_entry.key<<" "<<victim_entry.data.correlatedAddr;
-        pp->logs.push_back(oss1.str());
-        
-        ret = true;
+    auto victim = table.insert(key, data, priority);
+    if (victim.has_value()) {
+        if (track_triggers)
+            reverse_metatable.erase(victim->data.correlatedAddr, victim->key);
+
+        auto reason = (victim->key != key) ? prophet::event_detail::CAPACITY : prophet::event_detail::CONFLICT;
+        if (pp != nullptr)
+            pp->events->record({pp->parent->current_cycle(), 0, victim->key, victim->data.correlatedAddr, 0, prophet::event_type::EVICT, reason});
     }
-    std::ostringstream oss;
-    oss<<std::dec<<pp->parent->current_cycle()<< " ADD "<<std::hex<<key<<" "<<data.correlatedAddr;
-    //pp->logs.push_back(oss.str());
-    pp->logs.push_back(oss.str());
-    
-        
-    return ret;
+
+    if (pp != nullptr)
+        pp->events->record({pp->parent->current_cycle(), 0, key, data.correlatedAddr, 0, prophet::event_type::ADD});
+
+    return victim.has_value();
 }
 
 // } // namespace prefetch
@@ -12,15 +12,22 @@
 #include <random>
 #include <type_traits>
 #include <cstdint>
+#include <memory>
 #include "champsim.h"
+#include "msl/assoc_table.h"
 #include "cache.h"
 #include "bakshalipour_framework.h"
+#include "event_log.h"
+#include "hints.h"
+#include "ip_table.h"
+#include "reverse_index.h"
 
 #define META_TABLE_SIZE 196608
 #define META_TABLE_ASSOC 12
 #define MRB_TABLE_SIZE 65526
 #define MRB_TABLE_ASSOC 16
 #define MRB_MAX_COUNTER 3
+#define TRAIN_TABLE_SIZE 128
 
 #define IS_TRAIN 0
 #define ENABLE_MRB 1
@@ -97,23 +104,6 @@ struct MetaEntry : public TaggedEntry
     }
 };
 
-struct TrainEntry
-{
-    TrainEntry()
-    {
-        issued = 0;
-        solved = 0;
-        meta_inserted = 0;
-        meta_used = 0;
-        protect = true;
-    }
-    uint32_t issued;
-    uint32_t solved;
-    uint32_t meta_inserted;
-    uint32_t meta_used;
-    bool protect;
-};
-
 struct ProphetMetaTableEntry
 {
 
@@ -125,16 +115,19 @@ struct ProphetMetaTableEntry
     ProphetMetaTableEntry(uint64_t addr) : correlatedAddr(addr) {};
 };
 
-class ProphetMetaTable : public LRUSetAssociativeCache<ProphetMetaTableEntry>
+/*
+    The metadata table. Victims are chosen by the lowest insertion priority, and among those the most recently used entry.
+*/
+class ProphetMetaTable
 {
-    typedef LRUSetAssociativeCache<ProphetMetaTableEntry> Super;
-
 public:
-
-     std::unordered_map<uint64_t, std::set<uint64_t>> reverse_metatable;
+    /* The triggers of each correlated address, kept only when track_triggers is set */
+    prophet::reverse_index reverse_metatable;
+    bool track_triggers = false;
     prophet_profile *pp;
 
-    ProphetMetaTable(int size, int num_ways) : Super(size, num_ways), priority_pgo(num_sets, vector<uint8_t>(num_ways, 0)), pp(nullptr)
+    ProphetMetaTable(int size, int assoc)
+        : pp(nullptr), table(static_cast<std::size_t>(size / assoc), static_cast<std::size_t>(assoc)), num_sets(table.sets())
     {}
 
     void setpp(prophet_profile * p) {
@@ -143,12 +136,7 @@ public:
 
     ProphetMetaTableEntry *find(uint64_t key)
     {
-        Entry *entry = Super::find(key);
-        if (!entry)
-        {
-            return nullptr;
-        }
-        return &(entry->data);
+        return table.find(key);
     }
 
     /*
@@ -157,36 +145,21 @@ public:
     */
     bool insert(uint64_t key, const ProphetMetaTableEntry &data, uint8_t priority = 0);
 
-    Entry *erase(uint64_t key)
+    bool erase(uint64_t key)
     {
-        return Super::erase(key);
+        return table.erase(key).has_value();
     }
 
-    /* @override */
-    int select_victim(uint64_t index)
+    void set_mru(uint64_t key)
     {
-        uint8_t min_priority = 255;
-        uint64_t min_lru = UINT64_MAX;
-        int victim_index = 0;
-        vector<uint8_t> &priority_set = this->priority_pgo[index];
-        vector<uint64_t> &lru_set = this->lru[index];
-        for (size_t i = 0; i < num_ways; i++)
-        {
-            if (min_priority > priority_set[i]){
-                min_priority = priority_set[i];
-                min_lru = lru_set[i];
-                victim_index = i;
-            }else if (min_priority == priority_set[i]){
-                if (min_lru < lru_set[i]){
-                    min_lru = lru_set[i];
-                    victim_index = i;
-                }
-            }
-        }
-        return victim_index;
+        table.touch(key);
     }
-    
-    vector<vector<uint8_t>> priority_pgo;
+
+private:
+    champsim::msl::assoc_table<ProphetMetaTableEntry, champsim::msl::table_policy::priority_lru<true>> table;
+
+public:
+    const std::size_t num_sets;
 };
 
 struct ProphetMRBTableEntry
@@ -197,60 +170,43 @@ struct ProphetMRBTableEntry
     ProphetMRBTableEntry(uint64_t addr) : correlatedAddr(addr), counter(0) {};
 };
 
-class ProphetMRBTable : public LRUSetAssociativeCache<ProphetMRBTableEntry>
+/*
+    The MRB table. Victims are chosen by the lowest reuse counter.
+*/
+class ProphetMRBTable
 {
-    typedef LRUSetAssociativeCache<ProphetMRBTableEntry> Super;
+    struct counter_of
+    {
+        uint8_t operator()(const ProphetMRBTableEntry &entry) const { return entry.counter; }
+    };
 
 public:
-    ProphetMRBTable(int size, int num_ways) : Super(size, num_ways)
+    ProphetMRBTable(int size, int num_ways) : table(static_cast<std::size_t>(size / num_ways), static_cast<std::size_t>(num_ways))
     {
-        // assert(__builtin_popcount(size) == 1);
     }
 
     ProphetMRBTableEntry *find(uint64_t key)
     {
-        Entry *entry = Super::find(key);
-        if (!entry)
-        {
-            return nullptr;
-        }
-        return &(entry->data);
+        return table.find(key);
     }
 
     void insert(uint64_t key, const ProphetMRBTableEntry &data)
     {
-        Super::insert(key, data);
-        Super::set_mru(key);
+        table.insert(key, data);
     }
 
-    Entry *erase(uint64_t key)
+    bool erase(uint64_t key)
     {
-        return Super::erase(key);
+        return table.erase(key).has_value();
     }
 
-    /* @override */
-    int select_victim(uint64_t index)
+    void set_mru(uint64_t key)
     {
-        uint8_t min_counter = UINT8_MAX;
-        uint64_t min_lru = UINT64_MAX;
-        vector<uint64_t> &lru_set = this->lru[index];
-        int victim_index = 0;
-        for (size_t i = 0; i < num_ways; i++)
-        {
-            if (!entries[index][i].valid){
-                return i;
-            }else if (entries[index][i].data.counter < min_counter){
-                min_counter = entries[index][i].data.counter;
-                victim_index = i;
-            }else if (entries[index][i].data.counter == min_counter){
-                if (min_lru < lru_set[i]){
-                    min_lru = lru_set[i];
-                    victim_index = i;
-                }
-            }
-        }
-        return victim_index;
+        table.touch(key);
     }
+
+private:
+    champsim::msl::assoc_table<ProphetMRBTableEntry, champsim::msl::table_policy::min_counter<counter_of>> table;
 };
 
 class prophet_profile : public champsim::modules::prefetcher
@@ -264,9 +220,8 @@ public:
     std::string benchmark = champsim::global_trace_name;
     bool enableInsertFilter = true; 
     bool enablePGLRU = true;
-    std::map<uint64_t, int> profileReplTable;
+    std::unique_ptr<prophet::hint_table> hints = std::make_unique<prophet::hint_table>(); // the replacement priority and insertion permission of each PC, from the profile
     std::map<uint64_t, int32_t> profileUtiTable;
-    std::set<uint64_t> profileInsertTable;
     const bool enableDRA = false;
     bool enableMRB = ENABLE_MRB;
     int globalDegree = 1;
@@ -278,9 +233,7 @@ public:
      * Information used to create a new PC table. All of them behave equally.
      */
     
-    std::map<uint64_t, TrainEntry> trainTable;
-
-    std::map<uint64_t, uint32_t> missTable; // the miss number of each PC
+    prophet::ip_table ipTable; // the last addr, miss number, and training entry of each PC
 
     ProphetMetaTable *metaTable = new ProphetMetaTable(META_TABLE_SIZE, META_TABLE_ASSOC);
 
@@ -288,16 +241,14 @@ public:
 
     ProphetMRBTable *mrbTable = new ProphetMRBTable(MRB_TABLE_SIZE, MRB_TABLE_ASSOC);
 
-    std::unordered_map<uint64_t, uint64_t> pcTable; // record the last addr of PCs
-
     std::set<uint64_t> metaUsedPool;
 
     std::set<uint64_t> metaInsertedPool;
 
-    std::map<uint64_t, uint64_t> prefetched_addr; // <block_addr, trigger pc>
+    std::unordered_map<uint64_t, uint64_t> prefetched_addr; // <block_addr, trigger pc>
 
-    std::string out_file = "profile.txt";
-    std::vector<std::string> logs;
+    std::string out_file = "profile.events.gz";
+    std::unique_ptr<prophet::event_log> events = std::make_unique<prophet::event_log>();
 
     std::string toProfilePath(const std::string& full_path) {
         size_t last_slash = full_path.find_last_of('/');
@@ -329,7 +280,7 @@ public:
                                     ? file_part.substr(0, last_dot)
                                     : file_part.substr(0, second_last_dot);
 
-        std::string profile_path = "/mnt/data/lyq/Kairos2/expr/log/baseline/"+ base_name + ".txt";
+        std::string profile_path = "/mnt/data/lyq/Kairos2/expr/log/baseline/"+ base_name + ".events.gz";
         return profile_path;
 
     }
@@ -374,19 +325,12 @@ public:
     void outPrefetcherPGOInfo();
 
     uint64_t get_last(uint64_t ip) {
-        if(pcTable.find(ip) != pcTable.end()) {
-            return pcTable[ip];
-        }else {
-            return 0;
-        }
+        prophet::ip_record *rec = ipTable.find(ip);
+        return rec ? rec->last_addr : 0;
     };
 
-    std::set<uint64_t> get_triggers(uint64_t target) {
-        if(metaTable->reverse_metatable.find(target) != metaTable->reverse_metatable.end()){
-            return metaTable->reverse_metatable[target];
-        } else {
-            return std::set<uint64_t>();
-        }
+    prophet::trigger_view get_triggers(uint64_t target) const {
+        return metaTable->reverse_metatable.triggers(target);
     };
 
 
@@ -396,15 +340,25 @@ public:
     using champsim::modules::prefetcher::prefetcher;
 
     void prefetcher_initialize(){
+        parent = intern_;
         metaTable->setpp(this);
         benchmark = champsim::global_trace_name;
     
         globalDegree = 1;
         enableMRB = false;
 
+        // Without a profile, this run is the training run that produces one
+        if (!intern_->prefetcher_profile.empty()) {
+            hints->open(intern_->prefetcher_profile);
+            inTraining = false;
+            cout << "prophet_profile: " << hints->size() << " hints loaded from " << intern_->prefetcher_profile << endl;
+        }
+
         out_file = toProfilePath(benchmark);
         
         cout << out_file << endl;
+        // The triggers are only needed to annotate logged misses and hits
+        metaTable->track_triggers = !out_file.empty() && events->open(out_file);
     }
 
     uint32_t prefetcher_cache_operate(champsim::address addr, champsim::address ip, uint8_t cache_hit, bool useful_prefetch, access_type type,
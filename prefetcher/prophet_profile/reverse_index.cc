@@ -0,0 +1,158 @@
+#include "reverse_index.h"
+
+#include <algorithm>
+#include <cassert>
+
+prophet::reverse_index::reverse_index(std::size_t expected_targets)
+{
+  std::size_t capacity = 16;
+  while (capacity * 3 < expected_targets * 4)
+    capacity *= 2;
+  slots.resize(capacity);
+}
+
+std::size_t prophet::reverse_index::home(uint64_t target) const
+{
+  // splitmix64 finalizer
+  target ^= target >> 30;
+  target *= 0xbf58476d1ce4e5b9ull;
+  target ^= target >> 27;
+  target *= 0x94d049bb133111ebull;
+  target ^= target >> 31;
+  return static_cast<std::size_t>(target) & (std::size(slots) - 1);
+}
+
+std::size_t prophet::reverse_index::find(uint64_t target) const
+{
+  const auto mask = std::size(slots) - 1;
+  for (auto pos = home(target); slots[pos].count != 0; pos = (pos + 1) & mask) {
+    if (slots[pos].target == target)
+      return pos;
+  }
+  return std::size(slots);
+}
+
+const uint64_t* prophet::reverse_index::data(const slot& s) const
+{
+  if (s.count > INLINE_TRIGGERS)
+    return std::data(spilled[s.spill]);
+  return std::data(s.inline_triggers);
+}
+
+void prophet::reverse_index::insert(uint64_t target, uint64_t trigger)
+{
+  if ((num_targets + 1) * 4 > std::size(slots) * 3)
+    grow();
+
+  const auto mask = std::size(slots) - 1;
+  auto pos = home(target);
+  while (slots[pos].count != 0 && slots[pos].target != target)
+    pos = (pos + 1) & mask;
+
+  auto& s = slots[pos];
+  if (s.count == 0) {
+    s.target = target;
+    ++num_targets;
+  }
+
+  auto first = data(s);
+  auto last = first + s.count;
+  auto it = std::lower_bound(first, last, trigger);
+  if (it != last && *it == trigger)
+    return;
+
+  if (s.count < INLINE_TRIGGERS) {
+    auto inline_it = std::next(std::begin(s.inline_triggers), std::distance(first, it));
+    std::copy_backward(inline_it, std::next(std::begin(s.inline_triggers), s.count), std::next(std::begin(s.inline_triggers), s.count + 1));
+    *inline_it = trigger;
+  } else {
+    if (s.count == INLINE_TRIGGERS) {
+      // Move the inline triggers out to a list of their own
+      uint32_t spill_idx;
+      if (std::empty(free_spills)) {
+        spill_idx = static_cast<uint32_t>(std::size(spilled));
+        spilled.emplace_back();
+      } else {
+        spill_idx = free_spills.back();
+        free_spills.pop_back();
+      }
+      spilled[spill_idx].assign(std::begin(s.inline_triggers), std::end(s.inline_triggers));
+      s.spill = spill_idx;
+    }
+    auto& list = spilled[s.spill];
+    list.insert(std::next(std::begin(list), std::distance(first, it)), trigger);
+  }
+  ++s.count;
+}
+
+void prophet::reverse_index::erase(uint64_t target, uint64_t trigger)
+{
+  auto pos = find(target);
+  if (pos == std::size(slots))
+    return;
+
+  auto& s = slots[pos];
+  auto first = data(s);
+  auto last = first + s.count;
+  auto it = std::lower_bound(first, last, trigger);
+  if (it == last || *it != trigger)
+    return;
+
+  if (s.count > INLINE_TRIGGERS) {
+    auto& list = spilled[s.spill];
+    list.erase(std::next(std::begin(list), std::distance(first, it)));
+    if (std::size(list) == INLINE_TRIGGERS) {
+      // Bring the remaining triggers back inline
+      std::copy(std::begin(list), std::end(list), std::begin(s.inline_triggers));
+      list.clear();
+      free_spills.push_back(s.spill);
+    }
+  } else {
+    auto inline_it = std::next(std::begin(s.inline_triggers), std::distance(first, it));
+    std::copy(std::next(inline_it), std::next(std::begin(s.inline_triggers), s.count), inline_it);
+  }
+
+  if (--s.count == 0)
+    remove_slot(pos);
+}
+
+prophet::trigger_view prophet::reverse_index::triggers(uint64_t target) const
+{
+  auto pos = find(target);
+  if (pos == std::size(slots))
+    return {};
+  auto first = data(slots[pos]);
+  return {first, first + slots[pos].count};
+}
+
+void prophet::reverse_index::grow()
+{
+  std::vector<slot> old_slots(2 * std::size(slots));
+  std::swap(slots, old_slots);
+
+  const auto mask = std::size(slots) - 1;
+  for (const auto& s : old_slots) {
+    if (s.count == 0)
+      continue;
+    auto pos = home(s.target);
+    while (slots[pos].count != 0)
+      pos = (pos + 1) & mask;
+    slots[pos] = s;
+  }
+}
+
+void prophet::reverse_index::remove_slot(std::size_t pos)
+{
+  // Backward-shift deletion: pull later members of the probe run into the hole, so that lookups need no tombstones
+  const auto mask = std::size(slots) - 1;
+  for (auto next = (pos + 1) & mask; slots[next].count != 0; next = (next + 1) & mask) {
+    auto desired = home(slots[next].target);
+    if (((next - desired) & mask) >= ((next - pos) & mask)) {
+      slots[pos] = slots[next];
+      pos = next;
+    }
+  }
+  slots[pos] = slot{};
+  assert(num_targets > 0);
+  --num_targets;
+}
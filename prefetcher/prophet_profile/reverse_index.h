@@ -0,0 +1,69 @@
+#ifndef PROPHET_REVERSE_INDEX_H
+#define PROPHET_REVERSE_INDEX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace prophet
+{
+/**
+ * A non-owning view of the triggers of one target, in ascending order. It is invalidated by any change to the index that produced it.
+ */
+class trigger_view
+{
+  const uint64_t* first = nullptr;
+  const uint64_t* last = nullptr;
+
+public:
+  trigger_view() = default;
+  trigger_view(const uint64_t* begin_, const uint64_t* end_) : first(begin_), last(end_) {}
+
+  [[nodiscard]] const uint64_t* begin() const { return first; }
+  [[nodiscard]] const uint64_t* end() const { return last; }
+  [[nodiscard]] std::size_t size() const { return static_cast<std::size_t>(last - first); }
+  [[nodiscard]] bool empty() const { return first == last; }
+};
+
+/**
+ * Maps each correlated block of the metadata table back to the trigger blocks that predict it.
+ *
+ * Targets live in an open-addressed table with linear probing. Almost every target has one or two triggers, which are stored inline in its slot; a
+ * target with more moves its triggers to a separate list, and moves them back when it shrinks again. Empty targets are removed immediately.
+ */
+class reverse_index
+{
+public:
+  constexpr static std::size_t INLINE_TRIGGERS = 2;
+
+  explicit reverse_index(std::size_t expected_targets = 1024);
+
+  void insert(uint64_t target, uint64_t trigger);
+  void erase(uint64_t target, uint64_t trigger);
+  [[nodiscard]] trigger_view triggers(uint64_t target) const;
+
+  [[nodiscard]] std::size_t size() const { return num_targets; }
+
+private:
+  struct slot {
+    uint64_t target = 0;
+    uint32_t count = 0; // zero marks an empty slot
+    uint32_t spill = 0; // the index into spilled, when count exceeds INLINE_TRIGGERS
+    std::array<uint64_t, INLINE_TRIGGERS> inline_triggers{};
+  };
+
+  std::vector<slot> slots; // the size is always a power of two
+  std::vector<std::vector<uint64_t>> spilled;
+  std::vector<uint32_t> free_spills;
+  std::size_t num_targets = 0;
+
+  [[nodiscard]] std::size_t home(uint64_t target) const;
+  [[nodiscard]] std::size_t find(uint64_t target) const;
+  [[nodiscard]] const uint64_t* data(const slot& s) const;
+  void grow();
+  void remove_slot(std::size_t pos);
+};
+} // namespace prophet
+
+#endif
@@ -0,0 +1,168 @@
+#include "reuse_distance.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <fmt/core.h>
+#include <nlohmann/json.hpp>
+
+#include "cache.h"
+
+namespace
+{
+uint64_t mix(uint64_t x)
+{
+  // splitmix64 finalizer, so that sampling does not depend on address patterns
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebull;
+  x ^= x >> 31;
+  return x;
+}
+
+nlohmann::json to_json(const reuse_distance::histogram& hist) { return nlohmann::json{{"cold", hist.cold}, {"histogram", hist.bins}}; }
+} // namespace
+
+reuse_distance_sampler::reuse_distance_sampler(std::size_t max_tracked_) : max_tracked(std::max<std::size_t>(max_tracked_, 1)), fenwick(2 * max_tracked + 1)
+{
+}
+
+void reuse_distance_sampler::fenwick_add(std::size_t time, long amount)
+{
+  for (auto i = time + 1; i < std::size(fenwick); i += i & (~i + 1)) {
+    fenwick[i] += amount;
+  }
+}
+
+long reuse_distance_sampler::fenwick_prefix(std::size_t time) const
+{
+  long sum = 0;
+  for (auto i = time + 1; i > 0; i -= i & (~i + 1)) {
+    sum += fenwick[i];
+  }
+  return sum;
+}
+
+void reuse_distance_sampler::compact()
+{
+  // Renumber the live access times densely from zero, preserving their order
+  std::vector<std::pair<std::size_t, uint64_t>> order;
+  order.reserve(std::size(tracked));
+  std::transform(std::cbegin(tracked), std::cend(tracked), std::back_inserter(order), [](const auto& x) { return std::pair{x.second.last_access, x.first}; });
+  std::sort(std::begin(order), std::end(order));
+
+  std::fill(std::begin(fenwick), std::end(fenwick), 0);
+  now = 0;
+  for (auto [time, block] : order) {
+    tracked.at(block).last_access = now;
+    fenwick_add(now, 1);
+    ++now;
+  }
+}
+
+void reuse_distance_sampler::shrink()
+{
+  while (std::size(tracked) > max_tracked) {
+    threshold = std::prev(std::end(by_hash))->first;
+    while (!std::empty(by_hash) && std::prev(std::end(by_hash))->first >= threshold) {
+      auto victim = std::prev(std::end(by_hash));
+      fenwick_add(tracked.at(victim->second).last_access, -1);
+      tracked.erase(victim->second);
+      by_hash.erase(victim);
+    }
+  }
+}
+
+auto reuse_distance_sampler::access(uint64_t block) -> std::optional<sample>
+{
+  const auto hash = mix(block) % HASH_MODULUS;
+  if (hash >= threshold) {
+    return std::nullopt;
+  }
+
+  if (now == std::size(fenwick) - 1) {
+    compact();
+  }
+
+  sample result{std::nullopt, 1.0 / sampling_rate()};
+  if (auto found = tracked.find(block); found != std::end(tracked)) {
+    auto distinct = fenwick_prefix(now - 1) - fenwick_prefix(found->second.last_access);
+    result.distance = static_cast<double>(distinct) * result.weight;
+    fenwick_add(found->second.last_access, -1);
+    found->second.last_access = now;
+  } else {
+    tracked.emplace(block, tracked_entry{hash, now});
+    by_hash.emplace(hash, block);
+  }
+
+  fenwick_add(now, 1);
+  ++now;
+  shrink();
+
+  return result;
+}
+
+double reuse_distance_sampler::sampling_rate() const { return static_cast<double>(threshold) / static_cast<double>(HASH_MODULUS); }
+
+std::size_t reuse_distance_sampler::tracked_blocks() const { return std::size(tracked); }
+
+void reuse_distance::histogram::add(const reuse_distance_sampler::sample& s)
+{
+  if (!s.distance.has_value()) {
+    cold += s.weight;
+    return;
+  }
+
+  auto bin = (s.distance.value() < 1) ? 0 : 1 + static_cast<std::size_t>(std::floor(std::log2(s.distance.value())));
+  bins.at(std::min(bin, NUM_BINS - 1)) += s.weight;
+}
+
+uint32_t reuse_distance::prefetcher_cache_operate(champsim::address addr, champsim::address ip, uint8_t cache_hit, bool useful_prefetch, access_type type,
+                                                  uint32_t metadata_in, std::string latepf)
+{
+  auto result = sampler.access(champsim::block_number{addr}.to<uint64_t>());
+  if (result.has_value()) {
+    type_histograms.at(champsim::to_underlying(type)).add(result.value());
+
+    auto ip_hist = ip_histograms.find(ip.to<uint64_t>());
+    if (ip_hist == std::end(ip_histograms) && std::size(ip_histograms) < MAX_TRACKED_IPS) {
+      ip_hist = ip_histograms.try_emplace(ip.to<uint64_t>()).first;
+    }
+    (ip_hist == std::end(ip_histograms) ? other_ip_histogram : ip_hist->second).add(result.value());
+  }
+
+  // This module only observes, so it contributes nothing to the metadata that is combined across chained prefetchers
+  return 0;
+}
+
+void reuse_distance::prefetcher_final_stats()
+{
+  std::vector<double> bin_lower_bounds{0};
+  for (std::size_t i = 1; i < NUM_BINS; ++i) {
+    bin_lower_bounds.push_back(std::ldexp(1.0, static_cast<int>(i) - 1));
+  }
+
+  nlohmann::json types;
+  for (std::size_t i = 0; i < std::size(type_histograms); ++i) {
+    types[std::string{access_type_names.at(i)}] = to_json(type_histograms.at(i));
+  }
+
+  nlohmann::json ips;
+  for (const auto& [ip, hist] : ip_histograms) {
+    ips[fmt::format("{:#x}", ip)] = to_json(hist);
+  }
+
+  nlohmann::json output{{"cache", intern_->NAME},
+                        {"sampling rate", sampler.sampling_rate()},
+                        {"bin lower bounds", bin_lower_bounds},
+                        {"access types", types},
+                        {"ips", ips},
+                        {"other ips", to_json(other_ip_histogram)}};
+
+  auto file_name = fmt::format("{}.reuse_distance.json", intern_->NAME);
+  std::ofstream file{file_name};
+  file << output.dump(2) << '\n';
+  fmt::print("{} reuse distance profile written to {}\n", intern_->NAME, file_name);
+}
@@ -0,0 +1,91 @@
+#ifndef PREFETCHER_REUSE_DISTANCE_H
+#define PREFETCHER_REUSE_DISTANCE_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "address.h"
+#include "champsim.h"
+#include "modules.h"
+
+/**
+ * Measures block-granularity reuse distances (the number of distinct blocks touched between two accesses to the same block) in the access stream.
+ *
+ * Blocks are spatially sampled by a hash of their address, in the manner of SHARDS. At most max_tracked blocks are kept: when the set grows past that
+ * bound, the sampling threshold is lowered and the blocks above it are dropped. The distinct blocks between two accesses are counted with a Fenwick tree
+ * over the time of each tracked block's most recent access, so each access costs O(log max_tracked).
+ */
+class reuse_distance_sampler
+{
+public:
+  constexpr static uint64_t HASH_MODULUS = uint64_t{1} << 24;
+
+  struct sample {
+    std::optional<double> distance; // empty if this is the first access to the block
+    double weight;                  // the number of accesses that this sample represents
+  };
+
+  explicit reuse_distance_sampler(std::size_t max_tracked);
+
+  /**
+   * Record an access to the block. Returns nothing if the block is not sampled.
+   */
+  std::optional<sample> access(uint64_t block);
+
+  [[nodiscard]] double sampling_rate() const;
+  [[nodiscard]] std::size_t tracked_blocks() const;
+
+private:
+  struct tracked_entry {
+    uint64_t hash;
+    std::size_t last_access;
+  };
+
+  std::size_t max_tracked;
+  uint64_t threshold = HASH_MODULUS;
+  std::size_t now = 0;
+  std::vector<long> fenwick;
+  std::unordered_map<uint64_t, tracked_entry> tracked;
+  std::set<std::pair<uint64_t, uint64_t>> by_hash; // (hash, block), so the largest hashes can be dropped first
+
+  void fenwick_add(std::size_t time, long amount);
+  [[nodiscard]] long fenwick_prefix(std::size_t time) const; // the number of tracked blocks last accessed at or before time
+  void compact();
+  void shrink();
+};
+
+/**
+ * An observe-only prefetcher that profiles the reuse distances seen by its cache, by access type and by IP.
+ * It never issues prefetches, so it can be chained with a real prefetcher to profile any cache level.
+ */
+struct reuse_distance : public champsim::modules::prefetcher {
+  constexpr static std::size_t NUM_BINS = 48; // bin 0 holds distance 0, bin k holds distances in [2^(k-1), 2^k)
+  constexpr static std::size_t MAX_TRACKED_BLOCKS = 1 << 15;
+  constexpr static std::size_t MAX_TRACKED_IPS = 256;
+
+  struct histogram {
+    std::array<double, NUM_BINS> bins{};
+    double cold = 0;
+
+    void add(const reuse_distance_sampler::sample& s);
+  };
+
+  reuse_distance_sampler sampler{MAX_TRACKED_BLOCKS};
+  std::array<histogram, static_cast<std::size_t>(access_type::NUM_TYPES)> type_histograms{};
+  std::unordered_map<uint64_t, histogram> ip_histograms{};
+  histogram other_ip_histogram{}; // accesses from IPs beyond the first MAX_TRACKED_IPS
+
+  using champsim::modules::prefetcher::prefetcher;
+
+  uint32_t prefetcher_cache_operate(champsim::address addr, champsim::address ip, uint8_t cache_hit, bool useful_prefetch, access_type type,
+                                    uint32_t metadata_in, std::string latepf);
+  void prefetcher_final_stats();
+};
+
+#endif
@@ -0,0 +1,121 @@
+#include "next_use_window.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <fmt/core.h>
+
+namespace
+{
+constexpr std::size_t READ_BATCH = 4096;
+}
+
+belady::next_use_window::next_use_window(std::size_t capacity_) : capacity(std::max<std::size_t>(capacity_, 1)), records(capacity), consumed(capacity, false)
+{
+}
+
+belady::next_use_window::~next_use_window() { close(); }
+
+void belady::next_use_window::open(const std::string& file_name)
+{
+  close();
+
+  file = ::gzopen(file_name.c_str(), "rb");
+  if (file == nullptr)
+    throw std::runtime_error{fmt::format("Cannot open the next-use index {}", file_name)};
+
+  char magic[std::size(MAGIC)];
+  if (::gzread(file, magic, sizeof(magic)) != sizeof(magic) || std::string_view{magic, sizeof(magic)} != MAGIC) {
+    close();
+    throw std::runtime_error{fmt::format("{} is not a next-use index", file_name)};
+  }
+
+  first_unconsumed.clear();
+  std::fill(std::begin(consumed), std::end(consumed), false);
+  window_begin = window_end = last_match = 0;
+  matched = unmatched = dropped = 0;
+  slide();
+}
+
+void belady::next_use_window::close()
+{
+  if (file != nullptr)
+    ::gzclose(file);
+  file = nullptr;
+  read_buffer.clear();
+  read_head = 0;
+}
+
+uint64_t belady::next_use_window::match(uint64_t block)
+{
+  auto found = first_unconsumed.find(block);
+  if (found == std::end(first_unconsumed)) {
+    ++unmatched;
+    return NEVER;
+  }
+
+  auto position = found->second;
+  auto next_use = records[slot(position)].next_use;
+  consume(position);
+  ++matched;
+  last_match = std::max(last_match, position);
+  slide();
+  return next_use;
+}
+
+uint64_t belady::next_use_window::peek(uint64_t block) const
+{
+  auto found = first_unconsumed.find(block);
+  return found == std::end(first_unconsumed) ? NEVER : found->second;
+}
+
+void belady::next_use_window::consume(uint64_t position)
+{
+  const auto& rec = records[slot(position)];
+  consumed[slot(position)] = true;
+
+  // Records of the same block are linked by their next use, so the next one is now the first unconsumed. If it is not yet in the window, it is
+  // registered when it is read.
+  if (rec.next_use < window_end)
+    first_unconsumed[rec.block] = rec.next_use;
+  else
+    first_unconsumed.erase(rec.block);
+}
+
+void belady::next_use_window::slide()
+{
+  // Drop consumed records from the front, and unconsumed ones that have fallen more than half the window behind the most recent match
+  const auto lag = static_cast<uint64_t>(capacity / 2);
+  while (window_begin < window_end && (consumed[slot(window_begin)] || window_begin + lag < last_match)) {
+    if (!consumed[slot(window_begin)]) {
+      consume(window_begin);
+      ++dropped;
+    }
+    ++window_begin;
+  }
+
+  next_use_record rec;
+  while (window_end - window_begin < capacity && read_record(rec)) {
+    records[slot(window_end)] = rec;
+    consumed[slot(window_end)] = false;
+    first_unconsumed.try_emplace(rec.block, window_end);
+    ++window_end;
+  }
+}
+
+bool belady::next_use_window::read_record(next_use_record& rec)
+{
+  if (read_head == std::size(read_buffer)) {
+    if (file == nullptr)
+      return false;
+
+    read_buffer.resize(READ_BATCH);
+    auto bytes = ::gzread(file, std::data(read_buffer), static_cast<unsigned>(READ_BATCH * sizeof(next_use_record)));
+    read_buffer.resize(bytes > 0 ? static_cast<std::size_t>(bytes) / sizeof(next_use_record) : 0);
+    read_head = 0;
+    if (std::empty(read_buffer))
+      return false;
+  }
+
+  rec = read_buffer[read_head++];
+  return true;
+}
@@ -0,0 +1,92 @@
+#ifndef REPLACEMENT_OPT_NEXT_USE_WINDOW_H
+#define REPLACEMENT_OPT_NEXT_USE_WINDOW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <zlib.h>
+
+namespace belady
+{
+/**
+ * One access of the next-use index: the accessed block, and the position in the index of the next access to the same block.
+ */
+struct next_use_record {
+  uint64_t block = 0;
+  uint64_t next_use = 0;
+};
+static_assert(sizeof(next_use_record) == 16, "The writer in expr/utils/next_use_index.py depends on this layout");
+
+/**
+ * A bounded window over a gzip-compressed next-use index, as written by expr/utils/next_use_index.py.
+ *
+ * The index is read in order, and the window holds the records from the oldest one that has not been consumed, up to a fixed number of records. Each
+ * demand access consumes the first unconsumed record of its block in the window. Records that fall too far behind the most recent match are dropped,
+ * so that accesses that the cache never sees do not hold the window back, and the window is refilled from the file as it slides.
+ *
+ * For every block, the position of its first unconsumed record in the window is kept in a map, so that matches and lookups take constant time.
+ */
+class next_use_window
+{
+public:
+  constexpr static std::string_view MAGIC{"OPTNXT01"};
+  constexpr static uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+  constexpr static std::size_t DEFAULT_CAPACITY = std::size_t{1} << 18;
+
+  explicit next_use_window(std::size_t capacity = DEFAULT_CAPACITY);
+  ~next_use_window();
+
+  next_use_window(const next_use_window&) = delete;
+  next_use_window& operator=(const next_use_window&) = delete;
+
+  /**
+   * Begin reading the given index. Throws std::runtime_error if it cannot be opened, or is not a next-use index.
+   */
+  void open(const std::string& file_name);
+  void close();
+
+  /**
+   * Consume the first unconsumed record of the block in the window. Returns the position of the next access to the block, or NEVER if it is not
+   * accessed again. If the block is not in the window, nothing is consumed and NEVER is returned.
+   */
+  uint64_t match(uint64_t block);
+
+  /**
+   * The position of the next access to the block, without consuming it, or NEVER if the block is not in the window.
+   */
+  [[nodiscard]] uint64_t peek(uint64_t block) const;
+
+  /**
+   * The position of the most recently matched record.
+   */
+  [[nodiscard]] uint64_t position() const { return last_match; }
+
+  uint64_t matched = 0;
+  uint64_t unmatched = 0;
+  uint64_t dropped = 0;
+
+private:
+  std::size_t capacity;
+  std::vector<next_use_record> records; // position p is held at p % capacity
+  std::vector<bool> consumed;
+  std::unordered_map<uint64_t, uint64_t> first_unconsumed;
+  uint64_t window_begin = 0;
+  uint64_t window_end = 0;
+  uint64_t last_match = 0;
+
+  gzFile file = nullptr;
+  std::vector<next_use_record> read_buffer;
+  std::size_t read_head = 0;
+
+  [[nodiscard]] std::size_t slot(uint64_t position) const { return static_cast<std::size_t>(position % capacity); }
+  void consume(uint64_t position);
+  void slide();
+  bool read_record(next_use_record& rec);
+};
+} // namespace belady
+
+#endif
@@ -0,0 +1,66 @@
+#include "opt.h"
+
+#include <cassert>
+#include <stdexcept>
+#include <fmt/core.h>
+
+opt::opt(CACHE* cache) : opt(cache, cache->NUM_SET, cache->NUM_WAY, belady::next_use_window::DEFAULT_CAPACITY) {}
+
+opt::opt(CACHE* cache, long sets, long ways, std::size_t window_size)
+    : replacement(cache), NUM_WAY(ways), way_blocks(static_cast<std::size_t>(sets * ways), 0), future(std::make_unique<belady::next_use_window>(window_size))
+{
+}
+
+void opt::initialize_replacement()
+{
+  if (std::empty(intern_->replacement_profile))
+    throw std::runtime_error{fmt::format("{} OPT replacement requires a next-use index as its replacement profile", intern_->NAME)};
+  if (!intern_->virtual_prefetch)
+    fmt::print("[{}] WARNING: OPT replacement reads virtual addresses from its index, but the cache does not use virtual addresses\n", intern_->NAME);
+
+  open(intern_->replacement_profile);
+}
+
+void opt::open(const std::string& file_name) { future->open(file_name); }
+
+long opt::find_victim(uint32_t triggering_cpu, uint64_t instr_id, long set, const champsim::cache_block* current_set, champsim::address ip,
+                      champsim::address full_addr, access_type type)
+{
+  const auto usable_ways = std::min<long>(NUM_WAY, static_cast<long>(intern_->get_available_ways()));
+
+  // Evict the block that is accessed furthest in the future. Blocks that are not in the window are all equally far, and the lowest of them is chosen.
+  long victim = 0;
+  uint64_t furthest = 0;
+  for (long way = 0; way < usable_ways; ++way) {
+    auto next_use = future->peek(way_blocks.at(static_cast<std::size_t>(set * NUM_WAY + way)));
+    if (way == 0 || next_use > furthest) {
+      victim = way;
+      furthest = next_use;
+    }
+  }
+
+  assert(0 <= victim);
+  assert(victim < usable_ways);
+  return victim;
+}
+
+void opt::replacement_cache_fill(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip, champsim::address victim_addr,
+                                 access_type type)
+{
+  way_blocks.at(static_cast<std::size_t>(set * NUM_WAY + way)) = champsim::block_number{full_addr}.to<uint64_t>();
+}
+
+void opt::update_replacement_state(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
+                                   champsim::address victim_addr, access_type type, uint8_t hit)
+{
+  // Only demand accesses are in the index. Prefetches and writebacks move no further through it.
+  if (access_type{type} != access_type::LOAD && access_type{type} != access_type::RFO)
+    return;
+
+  future->match(champsim::block_number{full_addr}.to<uint64_t>());
+}
+
+void opt::replacement_final_stats()
+{
+  fmt::print("{} OPT matched: {} unmatched: {} dropped: {}\n", intern_->NAME, future->matched, future->unmatched, future->dropped);
+}
@@ -0,0 +1,48 @@
+#ifndef REPLACEMENT_OPT_H
+#define REPLACEMENT_OPT_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "cache.h"
+#include "modules.h"
+#include "next_use_window.h"
+
+/**
+ * Belady's optimal replacement, as an upper bound for online policies.
+ *
+ * L. A. Belady. 1966. A study of replacement algorithms for a virtual-storage computer. IBM Systems Journal 5, 2, 78–101.
+ *
+ * The future is read from the next-use index given as the cache's replacement profile, which expr/utils/next_use_index.py writes from a trace. Each
+ * demand access is matched against the index, and the victim is the block whose next access is furthest away, or that is not accessed again within the
+ * window of the index. The index holds virtual addresses, so the cache must be configured with virtual_prefetch, and the simulation should run a single
+ * core.
+ */
+class opt : public champsim::modules::replacement
+{
+public:
+  explicit opt(CACHE* cache);
+  opt(CACHE* cache, long sets, long ways, std::size_t window_size);
+
+  void initialize_replacement();
+  long find_victim(uint32_t triggering_cpu, uint64_t instr_id, long set, const champsim::cache_block* current_set, champsim::address ip,
+                   champsim::address full_addr, access_type type);
+  void replacement_cache_fill(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip, champsim::address victim_addr,
+                              access_type type);
+  void update_replacement_state(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip, champsim::address victim_addr,
+                                access_type type, uint8_t hit);
+  void replacement_final_stats();
+
+  /**
+   * Read the future from the given index. This is done by initialize_replacement() with the cache's replacement profile.
+   */
+  void open(const std::string& file_name);
+
+private:
+  long NUM_WAY;
+  std::vector<uint64_t> way_blocks;
+  std::unique_ptr<belady::next_use_window> future; // the window is not movable, but modules must be
+};
+
+#endif
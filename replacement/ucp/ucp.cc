@@ -0,0 +1,154 @@
+#include "ucp.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <numeric>
+#include <fmt/core.h>
+#include <fmt/format.h>
+
+namespace
+{
+uint64_t hits_with_ways(const std::vector<uint64_t>& position_hits, long ways)
+{
+  auto end = std::next(std::begin(position_hits), std::clamp<long>(ways, 0, static_cast<long>(std::size(position_hits))));
+  return std::accumulate(std::begin(position_hits), end, uint64_t{0});
+}
+} // namespace
+
+std::vector<long> ucp::lookahead(const std::vector<std::vector<uint64_t>>& position_hits, long ways)
+{
+  // If there are more cores than ways, the ways go to the cores that gain the most from them, and the rest get none
+  const auto num_cores = static_cast<long>(std::size(position_hits));
+  std::vector<long> allocation(std::size(position_hits), num_cores <= ways ? 1 : 0);
+  auto balance = num_cores <= ways ? ways - num_cores : ways;
+
+  while (balance > 0) {
+    // Find the core and the number of additional ways with the largest marginal utility per way
+    double best_utility = -1;
+    std::size_t best_cpu = 0;
+    long best_ways = 1;
+    for (std::size_t cpu = 0; cpu < std::size(position_hits); ++cpu) {
+      auto base_hits = hits_with_ways(position_hits[cpu], allocation[cpu]);
+      for (long extra = 1; extra <= balance; ++extra) {
+        auto utility = static_cast<double>(hits_with_ways(position_hits[cpu], allocation[cpu] + extra) - base_hits) / static_cast<double>(extra);
+        if (utility > best_utility) {
+          best_utility = utility;
+          best_cpu = cpu;
+          best_ways = extra;
+        }
+      }
+    }
+
+    allocation[best_cpu] += best_ways;
+    balance -= best_ways;
+  }
+
+  return allocation;
+}
+
+ucp::ucp(CACHE* cache) : ucp(cache, cache->NUM_SET, cache->NUM_WAY, DEFAULT_EPOCH_ACCESSES) {}
+
+ucp::ucp(CACHE* cache, long sets, long ways, uint64_t epoch_accesses_) : ucp(cache, sets, ways, epoch_accesses_, NUM_CPUS) {}
+
+ucp::ucp(CACHE* cache, long sets, long ways, uint64_t epoch_accesses_, std::size_t num_cpus)
+    : replacement(cache), NUM_WAY(ways), epoch_accesses(epoch_accesses_), last_used_cycles(static_cast<std::size_t>(sets * ways), 0),
+      owners(static_cast<std::size_t>(sets * ways), std::numeric_limits<uint32_t>::max()),
+      umon(num_cpus, champsim::stack_distance_monitor{static_cast<std::size_t>((sets + UMON_SET_STRIDE - 1) / UMON_SET_STRIDE), static_cast<std::size_t>(ways)}),
+      position_hits(num_cpus, std::vector<uint64_t>(static_cast<std::size_t>(ways), 0)), ways_per_cpu(num_cpus, 0)
+{
+  // Begin with an even split of the ways. If there are more cores than ways, the later cores start with none.
+  for (long way = 0; way < ways; ++way) {
+    ++ways_per_cpu.at(static_cast<std::size_t>(way) % std::size(ways_per_cpu));
+  }
+}
+
+long ucp::find_victim(uint32_t triggering_cpu, uint64_t instr_id, long set, const champsim::cache_block* current_set, champsim::address ip,
+                      champsim::address full_addr, access_type type)
+{
+  const auto usable_ways = std::min<long>(NUM_WAY, static_cast<long>(intern_->get_available_ways()));
+  const auto set_begin = static_cast<std::size_t>(set * NUM_WAY);
+
+  // Count the blocks that each core holds in this set
+  std::vector<long> owned(std::size(ways_per_cpu), 0);
+  for (long way = 0; way < usable_ways; ++way) {
+    if (auto owner = owners[set_begin + static_cast<std::size_t>(way)]; owner < std::size(owned)) {
+      ++owned[owner];
+    }
+  }
+
+  // A core below its allocation takes a block from a core above its own, otherwise it replaces one of its own.
+  // Blocks that no core holds may be taken by anyone.
+  const bool take_from_others = owned.at(triggering_cpu) < ways_per_cpu.at(triggering_cpu);
+  auto in_partition = [&, this](std::size_t idx) {
+    auto owner = owners[idx];
+    if (owner >= std::size(owned)) {
+      return true;
+    }
+    return take_from_others ? (owned[owner] > ways_per_cpu[owner]) : (owner == triggering_cpu);
+  };
+
+  long victim = -1;
+  for (long way = 0; way < usable_ways; ++way) {
+    auto idx = set_begin + static_cast<std::size_t>(way);
+    if (in_partition(idx) && (victim < 0 || last_used_cycles[idx] < last_used_cycles[set_begin + static_cast<std::size_t>(victim)])) {
+      victim = way;
+    }
+  }
+
+  // If no block belongs to the chosen partition, fall back to the LRU block of the whole set
+  if (victim < 0) {
+    auto lru_begin = std::next(std::begin(last_used_cycles), set * NUM_WAY);
+    victim = std::distance(lru_begin, std::min_element(lru_begin, std::next(lru_begin, usable_ways)));
+  }
+
+  assert(0 <= victim);
+  assert(victim < usable_ways);
+  return victim;
+}
+
+void ucp::replacement_cache_fill(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip, champsim::address victim_addr,
+                                 access_type type)
+{
+  // Mark the way as being used on the current cycle, and by the filling core
+  last_used_cycles.at(static_cast<std::size_t>(set * NUM_WAY + way)) = cycle++;
+  owners.at(static_cast<std::size_t>(set * NUM_WAY + way)) = triggering_cpu;
+}
+
+void ucp::update_replacement_state(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip,
+                                   champsim::address victim_addr, access_type type, uint8_t hit)
+{
+  if (access_type{type} == access_type::WRITE) // Skip this for writebacks
+    return;
+
+  if (hit)
+    last_used_cycles.at(static_cast<std::size_t>(set * NUM_WAY + way)) = cycle++;
+
+  // Only the sampled sets are shadowed by the utility monitors
+  if (set % UMON_SET_STRIDE == 0) {
+    auto position = umon.at(triggering_cpu).access(set / UMON_SET_STRIDE, champsim::block_number{full_addr}.to<uint64_t>());
+    if (position < std::size(position_hits.at(triggering_cpu)))
+      ++position_hits.at(triggering_cpu).at(position);
+  }
+
+  if (++accesses_this_epoch >= epoch_accesses)
+    repartition();
+}
+
+void ucp::repartition()
+{
+  ways_per_cpu = lookahead(position_hits, std::min<long>(NUM_WAY, static_cast<long>(intern_->get_available_ways())));
+
+  // Age the monitors, so that the next epoch is weighted towards recent behavior
+  for (auto& hits : position_hits) {
+    std::transform(std::cbegin(hits), std::cend(hits), std::begin(hits), [](auto x) { return x / 2; });
+  }
+
+  accesses_this_epoch = 0;
+  ++epochs;
+}
+
+void ucp::replacement_final_stats()
+{
+  fmt::print("{} UCP epochs: {} ways per core: {}\n", intern_->NAME, epochs, fmt::join(ways_per_cpu, " "));
+}
@@ -0,0 +1,65 @@
+#ifndef REPLACEMENT_UCP_H
+#define REPLACEMENT_UCP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "cache.h"
+#include "modules.h"
+#include "stack_distance_monitor.h"
+
+/**
+ * Utility-based cache partitioning.
+ *
+ * Moinuddin K. Qureshi and Yale N. Patt. 2006. Utility-Based Cache Partitioning: A Low-Overhead, High-Performance, Runtime Mechanism to Partition Shared
+ * Caches. In Proceedings of the 39th Annual IEEE/ACM International Symposium on Microarchitecture (MICRO 39). 423–432.
+ *
+ * Each core has a utility monitor, an LRU shadow tag directory over a sample of the sets, that counts how many hits the core would get with each number of
+ * ways. At the end of each epoch, the lookahead algorithm divides the cache's available ways among the cores, and victims are chosen so that each core
+ * converges to its allocation: a core below its allocation takes a block from a core above its own, and any other core replaces one of its own blocks.
+ */
+class ucp : public champsim::modules::replacement
+{
+public:
+  constexpr static long UMON_SET_STRIDE = 32;
+  constexpr static uint64_t DEFAULT_EPOCH_ACCESSES = 1 << 20;
+
+  /**
+   * Divide the ways among the cores, given the number of hits each core would get at each LRU stack position.
+   * Every core receives at least one way, unless there are more cores than ways.
+   */
+  static std::vector<long> lookahead(const std::vector<std::vector<uint64_t>>& position_hits, long ways);
+
+  explicit ucp(CACHE* cache);
+  ucp(CACHE* cache, long sets, long ways, uint64_t epoch_accesses);
+  ucp(CACHE* cache, long sets, long ways, uint64_t epoch_accesses, std::size_t num_cpus);
+
+  long find_victim(uint32_t triggering_cpu, uint64_t instr_id, long set, const champsim::cache_block* current_set, champsim::address ip,
+                   champsim::address full_addr, access_type type);
+  void replacement_cache_fill(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip, champsim::address victim_addr,
+                              access_type type);
+  void update_replacement_state(uint32_t triggering_cpu, long set, long way, champsim::address full_addr, champsim::address ip, champsim::address victim_addr,
+                                access_type type, uint8_t hit);
+  void replacement_final_stats();
+
+  [[nodiscard]] const std::vector<long>& allocation() const { return ways_per_cpu; }
+
+private:
+  long NUM_WAY;
+  uint64_t epoch_accesses;
+  uint64_t accesses_this_epoch = 0;
+  uint64_t epochs = 0;
+  uint64_t cycle = 0;
+
+  std::vector<uint64_t> last_used_cycles;
+  std::vector<uint32_t> owners;
+
+  std::vector<champsim::stack_distance_monitor> umon;
+  std::vector<std::vector<uint64_t>> position_hits; // indexed by cpu, then by LRU stack position
+  std::vector<long> ways_per_cpu;
+
+  void repartition();
+};
+
+#endif
@@ -20,7 +20,10 @@
 #include <cassert>
 #include <cmath>
 #include <iomanip>
+#include <istream>
 #include <numeric>
+#include <ostream>
+#include <stdexcept>
 #include <fmt/core.h>
 
 #include "bandwidth.h"
@@ -38,9 +41,14 @@ CACHE::CACHE(CACHE&& other)
       upper_levels(std::move(other.upper_levels)), lower_level(std::move(other.lower_level)), lower_translate(std::move(other.lower_translate)),
 
       cpu(other.cpu), NAME(std::move(other.NAME)), NUM_SET(other.NUM_SET), NUM_WAY(other.NUM_WAY), available_ways(other.available_ways), MSHR_SIZE(other.MSHR_SIZE), PQ_SIZE(other.PQ_SIZE),
-      HIT_LATENCY(other.HIT_LATENCY), FILL_LATENCY(other.FILL_LATENCY), OFFSET_BITS(other.OFFSET_BITS), block(std::move(other.block)), MAX_TAG(other.MAX_TAG),
+      HIT_LATENCY(other.HIT_LATENCY), FILL_LATENCY(other.FILL_LATENCY), OFFSET_BITS(other.OFFSET_BITS), SET_INDEX_MASK(other.SET_INDEX_MASK), block(std::move(other.block)),
+      keep_block_v_address(other.keep_block_v_address), keep_block_data(other.keep_block_data), block_v_address(std::move(other.block_v_address)),
+      block_data(std::move(other.block_data)), block_cpu(std::move(other.block_cpu)),
+      block_last_use(std::move(other.block_last_use)), block_use_clock(other.block_use_clock), MAX_TAG(other.MAX_TAG),
       MAX_FILL(other.MAX_FILL), prefetch_as_load(other.prefetch_as_load), match_offset_bits(other.match_offset_bits), virtual_prefetch(other.virtual_prefetch),
-      pref_activate_mask(std::move(other.pref_activate_mask)),
+      SET_SAMPLE_STRIDE(other.SET_SAMPLE_STRIDE), stack_monitor(std::move(other.stack_monitor)), pf_filter(std::move(other.pf_filter)),
+      pf_attribution(std::move(other.pf_attribution)), block_pf_trigger(std::move(other.block_pf_trigger)),
+      shadow_directories(std::move(other.shadow_directories)), prefetcher_profile(std::move(other.prefetcher_profile)), replacement_profile(std::move(other.replacement_profile)), heatmap(std::move(other.heatmap)), pref_activate_mask(std::move(other.pref_activate_mask)),
 
       sim_stats(std::move(other.sim_stats)), roi_stats(std::move(other.roi_stats)),
 
@@ -72,13 +80,30 @@ auto CACHE::operator=(CACHE&& other) -> CACHE&
   this->HIT_LATENCY = other.HIT_LATENCY;
   this->FILL_LATENCY = other.FILL_LATENCY;
   this->OFFSET_BITS = other.OFFSET_BITS;
+  this->SET_INDEX_MASK = other.SET_INDEX_MASK;
   ;
   this->block = std::move(other.block);
+  this->keep_block_v_address = other.keep_block_v_address;
+  this->keep_block_data = other.keep_block_data;
+  this->block_v_address = std::move(other.block_v_address);
+  this->block_data = std::move(other.block_data);
+  this->block_cpu = std::move(other.block_cpu);
+  this->block_last_use = std::move(other.block_last_use);
+  this->block_use_clock = other.block_use_clock;
   this->MAX_TAG = other.MAX_TAG;
   this->MAX_FILL = other.MAX_FILL;
   this->prefetch_as_load = other.prefetch_as_load;
   this->match_offset_bits = other.match_offset_bits;
   this->virtual_prefetch = other.virtual_prefetch;
+  this->SET_SAMPLE_STRIDE = other.SET_SAMPLE_STRIDE;
+  this->stack_monitor = std::move(other.stack_monitor);
+  this->pf_filter = std::move(other.pf_filter);
+  this->pf_attribution = std::move(other.pf_attribution);
+  this->block_pf_trigger = std::move(other.block_pf_trigger);
+  this->shadow_directories = std::move(other.shadow_directories);
+  this->prefetcher_profile = std::move(other.prefetcher_profile);
+  this->replacement_profile = std::move(other.replacement_profile);
+  this->heatmap = std::move(other.heatmap);
   this->pref_activate_mask = std::move(other.pref_activate_mask);
 
   this->sim_stats = std::move(other.sim_stats);
@@ -98,37 +123,34 @@ void CACHE::impl_setup_prefetcher_llc_connection(CACHE* llc_cache) const {
     pref_module_pimpl->impl_setup_prefetcher_llc_connection(llc_cache);
 }
 
-CACHE::tag_lookup_type::tag_lookup_type(const request_type& req, bool local_pref, bool skip)
+CACHE::tag_lookup_type::tag_lookup_type(request_type req, bool local_pref, bool skip)
     : address(req.address), v_address(req.v_address), data(req.data), ip(req.ip), instr_id(req.instr_id), pf_metadata(req.pf_metadata), cpu(req.cpu),
-      type(req.type), prefetch_from_this(local_pref), skip_fill(skip), is_translated(req.is_translated), instr_depend_on_me(req.instr_depend_on_me)
+      type(req.type), prefetch_from_this(local_pref), skip_fill(skip), is_translated(req.is_translated), instr_depend_on_me(std::move(req.instr_depend_on_me))
 {
 }
 
 CACHE::mshr_type::mshr_type(const tag_lookup_type& req, champsim::chrono::clock::time_point _time_enqueued)
-    : address(req.address), v_address(req.v_address), ip(req.ip), instr_id(req.instr_id), cpu(req.cpu), type(req.type),
-      prefetch_from_this(req.prefetch_from_this), prefetch_related(false), time_enqueued(_time_enqueued), instr_depend_on_me(req.instr_depend_on_me), to_return(req.to_return)
+    : address(req.address), v_address(req.v_address), ip(req.ip), instr_id(req.instr_id), cpu(req.cpu), pf_trigger(req.pf_trigger),
+      type(req.type), prefetch_from_this(req.prefetch_from_this), prefetch_related(false), time_enqueued(_time_enqueued), instr_depend_on_me(req.instr_depend_on_me), to_return(req.to_return)
 {
 }
 
 CACHE::mshr_type CACHE::mshr_type::merge(mshr_type predecessor, mshr_type successor)
 {
-  std::vector<uint64_t> merged_instr{};
-  std::vector<std::deque<response_type>*> merged_return{};
+  auto merged_instr = predecessor.instr_depend_on_me;
+  auto merged_return = predecessor.to_return;
+  champsim::set_union_into(merged_instr, successor.instr_depend_on_me);
+  champsim::set_union_into(merged_return, successor.to_return);
 
-  std::set_union(std::begin(predecessor.instr_depend_on_me), std::end(predecessor.instr_depend_on_me), std::begin(successor.instr_depend_on_me),
-                 std::end(successor.instr_depend_on_me), std::back_inserter(merged_instr));
-  std::set_union(std::begin(predecessor.to_return), std::end(predecessor.to_return), std::begin(successor.to_return), std::end(successor.to_return),
-                 std::back_inserter(merged_return));
-
-
-  mshr_type retval{(successor.type == access_type::PREFETCH) ? predecessor : successor};
+  // Only the dependency lists are consumed by this move, and those have already been merged above
+  mshr_type retval{(successor.type == access_type::PREFETCH) ? std::move(predecessor) : std::move(successor)};
 
   retval.prefetch_related = predecessor.prefetch_related || successor.prefetch_related;
   // set the time enqueued to the predecessor unless its a demand into prefetch, in which case we use the successor
   retval.time_enqueued =
       ((successor.type != access_type::PREFETCH && predecessor.type == access_type::PREFETCH)) ? successor.time_enqueued : predecessor.time_enqueued;
-  retval.instr_depend_on_me = merged_instr;
-  retval.to_return = merged_return;
+  retval.instr_depend_on_me = std::move(merged_instr);
+  retval.to_return = std::move(merged_return);
   retval.data_promise = predecessor.data_promise;
 
   if constexpr (champsim::debug_print) {
@@ -153,8 +175,6 @@ auto CACHE::fill_block(mshr_type mshr, uint32_t metadata) -> BLOCK
   to_fill.prefetch = mshr.prefetch_from_this;
   to_fill.dirty = (mshr.type == access_type::WRITE);
   to_fill.address = mshr.address;
-  to_fill.v_address = mshr.v_address;
-  to_fill.data = mshr.data_promise->data;
   to_fill.pf_metadata = metadata;
 
   return to_fill;
@@ -170,8 +190,54 @@ auto CACHE::matches_address(champsim::address addr) const
 template <typename T>
 champsim::address CACHE::module_address(const T& element) const
 {
-  auto address = virtual_prefetch ? element.v_address : element.address;
-  return champsim::address{address.slice_upper(match_offset_bits ? champsim::data::bits{} : OFFSET_BITS)};
+  return module_address(element.address, element.v_address);
+}
+
+champsim::address CACHE::module_address(champsim::address address, champsim::address v_address) const
+{
+  auto selected = virtual_prefetch ? v_address : address;
+  return champsim::address{selected.slice_upper(match_offset_bits ? champsim::data::bits{} : OFFSET_BITS)};
+}
+
+champsim::address CACHE::v_address_of(set_type::const_iterator way) const
+{
+  if (!keep_block_v_address) {
+    return champsim::address{};
+  }
+#ifdef LEAN_CACHE_BLOCKS
+  return block_v_address.at(static_cast<std::size_t>(std::distance(std::cbegin(block), way)));
+#else
+  return way->v_address;
+#endif
+}
+
+champsim::address CACHE::data_of(set_type::const_iterator way) const
+{
+  if (!keep_block_data) {
+    return champsim::address{};
+  }
+#ifdef LEAN_CACHE_BLOCKS
+  return block_data.at(static_cast<std::size_t>(std::distance(std::cbegin(block), way)));
+#else
+  return way->data;
+#endif
+}
+
+void CACHE::store_payload(set_type::const_iterator way, champsim::address v_address, champsim::address data)
+{
+#ifdef LEAN_CACHE_BLOCKS
+  const auto idx = static_cast<std::size_t>(std::distance(std::cbegin(block), way));
+  if (keep_block_v_address) {
+    block_v_address.at(idx) = v_address;
+  }
+  if (keep_block_data) {
+    block_data.at(idx) = data;
+  }
+#else
+  auto& blk = block.at(static_cast<std::size_t>(std::distance(std::cbegin(block), way)));
+  blk.v_address = keep_block_v_address ? v_address : champsim::address{};
+  blk.data = keep_block_data ? data : champsim::address{};
+#endif
 }
 
 bool CACHE::handle_fill(const mshr_type& fill_mshr)
@@ -212,7 +278,7 @@ bool CACHE::handle_fill(const mshr_type& fill_mshr)
 
     writeback_packet.cpu = fill_mshr.cpu;
     writeback_packet.address = way->address;
-    writeback_packet.data = way->data;
+    writeback_packet.data = data_of(way);
     writeback_packet.instr_id = fill_mshr.instr_id;
     writeback_packet.ip = champsim::address{};
     writeback_packet.type = access_type::WRITE;
@@ -232,7 +298,14 @@ bool CACHE::handle_fill(const mshr_type& fill_mshr)
 
   champsim::address evicting_address{};
   if (way != set_end && way->valid) {
-    evicting_address = module_address(*way);
+    evicting_address = module_address(way->address, v_address_of(way));
+  }
+
+  if (pf_filter.has_value()) {
+    pf_filter->erase(champsim::block_number{virtual_prefetch ? fill_mshr.v_address : fill_mshr.address}.to<uint64_t>());
+    if (way != set_end && way->valid) {
+      pf_filter->erase(champsim::block_number{virtual_prefetch ? v_address_of(way) : way->address}.to<uint64_t>());
+    }
   }
 
   auto metadata_thru = impl_prefetcher_cache_fill(module_address(fill_mshr), get_set_index(fill_mshr.address), way_idx,
@@ -240,22 +313,36 @@ bool CACHE::handle_fill(const mshr_type& fill_mshr)
   impl_replacement_cache_fill(fill_mshr.cpu, get_set_index(fill_mshr.address), way_idx, module_address(fill_mshr), fill_mshr.ip, evicting_address,
                               fill_mshr.type);
 
+  if constexpr (champsim::record_heatmap) {
+    heatmap->fill(get_set_index(fill_mshr.address), (way != set_end) ? way_idx : NUM_WAY, way != set_end && way->valid);
+  }
+
   if (way != set_end) {
+    const auto block_idx = static_cast<std::size_t>(std::distance(std::begin(block), way));
     if (way->valid && way->prefetch) {
-      ++sim_stats.pf_useless;
+      sim_stats.pf_useless += SET_SAMPLE_STRIDE;
+      if (pf_attribution.has_value()) {
+        pf_attribution->useless(block_pf_trigger.at(block_idx), SET_SAMPLE_STRIDE);
+      }
     }
 
     if (fill_mshr.type == access_type::PREFETCH) {
-      ++sim_stats.pf_fill;
+      sim_stats.pf_fill += SET_SAMPLE_STRIDE;
     }
 
     *way = fill_block(fill_mshr, metadata_thru);
+    store_payload(way, fill_mshr.v_address, fill_mshr.data_promise->data);
+    block_cpu.at(block_idx) = fill_mshr.cpu;
+    block_last_use.at(block_idx) = ++block_use_clock;
+    if (pf_attribution.has_value()) {
+      block_pf_trigger.at(block_idx) = fill_mshr.prefetch_from_this ? fill_mshr.pf_trigger : champsim::prefetch_attribution::NONE;
+    }
   }
 
   // COLLECT STATS
   if (fill_mshr.type != access_type::PREFETCH)
-    sim_stats.total_miss_latency_cycles += (current_time - (fill_mshr.time_enqueued + clock_period)) / clock_period;
-  sim_stats.mshr_return.increment(std::pair{fill_mshr.type, fill_mshr.cpu});
+    sim_stats.total_miss_latency_cycles += SET_SAMPLE_STRIDE * ((current_time - (fill_mshr.time_enqueued + clock_period)) / clock_period);
+  sim_stats.mshr_return.increment(std::pair{fill_mshr.type, fill_mshr.cpu}, SET_SAMPLE_STRIDE);
 
   response_type response{fill_mshr.address, fill_mshr.v_address, fill_mshr.data_promise->data, metadata_thru, fill_mshr.instr_depend_on_me};
   for (auto* ret : fill_mshr.to_return) {
@@ -268,7 +355,16 @@ bool CACHE::handle_fill(const mshr_type& fill_mshr)
 bool CACHE::try_hit(const tag_lookup_type& handle_pkt)
 {
   cpu = handle_pkt.cpu;
-  
+
+  // Sets outside of the sample are not modeled, so their accesses are answered at the tag check without touching the cache state or statistics
+  if (!is_sampled_set(handle_pkt.address)) {
+    response_type response{handle_pkt.address, handle_pkt.v_address, handle_pkt.data, handle_pkt.pf_metadata, handle_pkt.instr_depend_on_me};
+    for (auto* ret : handle_pkt.to_return) {
+      ret->push_back(response);
+    }
+    return true;
+  }
+
   // access cache
   auto [set_begin, set_end] = get_available_set_span(handle_pkt.address);
   auto way = std::find_if(set_begin, set_end, [matcher = matches_address(handle_pkt.address)](const auto& x) { return x.valid && matcher(x); });
@@ -314,27 +410,46 @@ bool CACHE::try_hit(const tag_lookup_type& handle_pkt)
   
 
   if (should_activate_prefetcher(handle_pkt)) {
+    // Without the cache's own prefetchers, a hit on a block that they brought in would have missed
+    if (handle_pkt.type != access_type::PREFETCH) {
+      for (auto& shadow : shadow_directories) {
+        shadow.access(shadow_key(module_address(handle_pkt)), !hit || useful_prefetch, SET_SAMPLE_STRIDE);
+      }
+    }
+
+    pf_trigger_ip = handle_pkt.ip.to<uint64_t>();
     metadata_thru = impl_prefetcher_cache_operate(module_address(handle_pkt), handle_pkt.ip, hit, useful_prefetch, handle_pkt.type, metadata_thru, was_prefetched);
+    pf_trigger_ip.reset();
   }
 
   // update replacement policy
   const auto way_idx = std::distance(set_begin, way);
+
+  if constexpr (champsim::record_heatmap) {
+    heatmap->access(get_set_index(handle_pkt.address), hit ? way_idx : NUM_WAY);
+  }
   impl_update_replacement_state(handle_pkt.cpu, get_set_index(handle_pkt.address), way_idx, module_address(handle_pkt), handle_pkt.ip, {}, handle_pkt.type,
                                 hit);
 
   if (hit) {
-    sim_stats.hits.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+    sim_stats.hits.increment(std::pair{handle_pkt.type, handle_pkt.cpu}, SET_SAMPLE_STRIDE);
+    record_stack_position(handle_pkt);
 
-    response_type response{handle_pkt.address, handle_pkt.v_address, way->data, metadata_thru, handle_pkt.instr_depend_on_me};
+    response_type response{handle_pkt.address, handle_pkt.v_address, data_of(way), metadata_thru, handle_pkt.instr_depend_on_me};
     for (auto* ret : handle_pkt.to_return) {
       ret->push_back(response);
     }
 
     way->dirty |= (handle_pkt.type == access_type::WRITE);
+    block_last_use.at(static_cast<std::size_t>(std::distance(std::begin(block), way))) = ++block_use_clock;
 
     // update prefetch stats and reset prefetch bit
     if (useful_prefetch) {
-      ++sim_stats.pf_useful;
+      sim_stats.pf_useful += SET_SAMPLE_STRIDE;
+      if (pf_attribution.has_value()) {
+        pf_attribution->useful(block_pf_trigger.at(static_cast<std::size_t>(std::distance(std::begin(block), way))), SET_SAMPLE_STRIDE);
+        pf_attribution->covered(handle_pkt.ip.to<uint64_t>(), SET_SAMPLE_STRIDE);
+      }
       way->prefetch = false;
     }
   }
@@ -342,6 +457,20 @@ bool CACHE::try_hit(const tag_lookup_type& handle_pkt)
   return hit;
 }
 
+void CACHE::record_stack_position(const tag_lookup_type& handle_pkt)
+{
+  if (!stack_monitor.has_value()) {
+    return;
+  }
+
+  auto position = stack_monitor->access(get_set_index(handle_pkt.address) / SET_SAMPLE_STRIDE, handle_pkt.address.slice_upper(OFFSET_BITS).to<uint64_t>());
+  if (position < std::size(sim_stats.stack_position_hits)) {
+    sim_stats.stack_position_hits[position] += SET_SAMPLE_STRIDE;
+  } else {
+    sim_stats.stack_misses += SET_SAMPLE_STRIDE;
+  }
+}
+
 auto CACHE::mshr_and_forward_packet(const tag_lookup_type& handle_pkt) -> std::pair<mshr_type, request_type>
 {
   mshr_type to_allocate{handle_pkt, current_time};
@@ -395,13 +524,16 @@ bool CACHE::handle_miss(const tag_lookup_type& handle_pkt)
       // Mark the prefetch as LATE
       if (mshr_entry->prefetch_from_this) {
 
-        ++sim_stats.pf_late; //  MSHR  
+        sim_stats.pf_late += SET_SAMPLE_STRIDE; //  MSHR  
         is_late = true;
+        if (pf_attribution.has_value()) {
+          pf_attribution->late(mshr_entry->pf_trigger, SET_SAMPLE_STRIDE);
+        }
       }
     }
 
     // COLLECT STATS
-    sim_stats.mshr_merge.increment(std::pair{to_allocate.type, to_allocate.cpu});
+    sim_stats.mshr_merge.increment(std::pair{to_allocate.type, to_allocate.cpu}, SET_SAMPLE_STRIDE);
 
     *mshr_entry = mshr_type::merge(*mshr_entry, to_allocate);
   } else {
@@ -419,6 +551,9 @@ bool CACHE::handle_miss(const tag_lookup_type& handle_pkt)
     // Allocate an MSHR
     if (mshr_pkt.second.response_requested) {
       MSHR.emplace_back(std::move(mshr_pkt.first));
+      if (pf_filter.has_value()) {
+        pf_filter->insert(champsim::block_number{virtual_prefetch ? handle_pkt.v_address : handle_pkt.address}.to<uint64_t>());
+      }
     }
   }
 
@@ -432,7 +567,11 @@ bool CACHE::handle_miss(const tag_lookup_type& handle_pkt)
   // }
   // ********** check pq (new)
 
-  sim_stats.misses.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+  sim_stats.misses.increment(std::pair{handle_pkt.type, handle_pkt.cpu}, SET_SAMPLE_STRIDE);
+  if (pf_attribution.has_value() && handle_pkt.type != access_type::PREFETCH) {
+    pf_attribution->miss(handle_pkt.ip.to<uint64_t>(), SET_SAMPLE_STRIDE);
+  }
+  record_stack_position(handle_pkt);
 
   return true;
 }
@@ -449,7 +588,8 @@ bool CACHE::handle_write(const tag_lookup_type& handle_pkt)
   to_allocate.data_promise.ready_at(current_time + (warmup ? champsim::chrono::clock::duration{} : FILL_LATENCY));
   inflight_writes.push_back(to_allocate);
 
-  sim_stats.misses.increment(std::pair{handle_pkt.type, handle_pkt.cpu});
+  sim_stats.misses.increment(std::pair{handle_pkt.type, handle_pkt.cpu}, SET_SAMPLE_STRIDE);
+  record_stack_position(handle_pkt);
 
   return true;
 }
@@ -457,10 +597,14 @@ bool CACHE::handle_write(const tag_lookup_type& handle_pkt)
 template <bool UpdateRequest>
 auto CACHE::initiate_tag_check(champsim::channel* ul)
 {
-  return [time = current_time + (warmup ? champsim::chrono::clock::duration{} : HIT_LATENCY), ul](const auto& entry) {
+  return [time = current_time + (warmup ? champsim::chrono::clock::duration{} : HIT_LATENCY), ul, this](const auto& entry) {
     CACHE::tag_lookup_type retval{entry};
     retval.event_cycle = time;
 
+    if (!retval.is_translated) {
+      ++this->untranslated_pages[translation_key(retval.v_address)];
+    }
+
     if constexpr (UpdateRequest) {
       if (entry.response_requested) {
         retval.to_return = {&ul->returned};
@@ -553,15 +697,43 @@ long CACHE::operate()
       champsim::transform_while_n(internal_PQ, std::back_inserter(inflight_tag_check), initiate_tag_bw, can_translate, initiate_tag_check<false>());
   initiate_tag_bw.consume(pq_bandwidth_consumed);
 
-  // Issue translations
-  std::for_each(std::begin(inflight_tag_check), std::end(inflight_tag_check), [this](auto& x) { this->issue_translation(x); });
-  std::for_each(std::begin(translation_stash), std::end(translation_stash), [this](auto& x) { this->issue_translation(x); });
+  // Issue translations. The tag checks initiated this cycle are the tail of inflight_tag_check, and every older entry has already made its
+  // request unless the translation queue turned it away. The rest of the queues are only walked while such a retry is pending, and a full
+  // translation queue ends the walk, since it would turn away every later request as well.
+  auto num_initiated = stash_bandwidth_consumed + pq_bandwidth_consumed
+                       + std::accumulate(std::begin(channels_bandwidth_consumed), std::end(channels_bandwidth_consumed), 0ll);
+  auto initiated_begin = std::prev(std::end(inflight_tag_check), num_initiated);
+  bool translation_queue_full = false;
+  auto retry_translations = [this, &translation_queue_full](auto first, auto last) {
+    for (auto it = first; this->translations_to_retry > 0 && !translation_queue_full && it != last; ++it) {
+      if (!it->is_translated && !it->translate_issued) {
+        translation_queue_full = !this->issue_translation(*it);
+        if (!translation_queue_full) {
+          --this->translations_to_retry;
+        }
+      }
+    }
+  };
+  retry_translations(std::begin(inflight_tag_check), initiated_begin);
+  for (auto it = initiated_begin; it != std::end(inflight_tag_check); ++it) {
+    if (!it->is_translated) {
+      translation_queue_full = translation_queue_full || !issue_translation(*it);
+      if (translation_queue_full) {
+        ++translations_to_retry;
+      }
+    }
+  }
+  retry_translations(std::begin(translation_stash), std::end(translation_stash));
+
+  // Every tag check is scheduled a fixed latency after it is initiated, and is appended in the order it was initiated, so inflight_tag_check
+  // is ordered by event_cycle. The entries that are due this cycle form a prefix, and nothing past it needs to be examined.
+  auto due_end = std::find_if_not(std::begin(inflight_tag_check), std::end(inflight_tag_check), is_ready);
 
   // Find entries that would be ready except that they have not finished translation, move them to the stash
-  auto [last_not_missed, stash_end] = champsim::extract_if(std::begin(inflight_tag_check), std::end(inflight_tag_check), std::back_inserter(translation_stash),
-                                                           [is_ready, is_translated](const auto& x) { return is_ready(x) && !is_translated(x); });
-  progress += std::distance(last_not_missed, std::end(inflight_tag_check));
-  inflight_tag_check.erase(last_not_missed, std::end(inflight_tag_check));
+  auto [last_not_missed, stash_end] = champsim::extract_if(std::begin(inflight_tag_check), due_end, std::back_inserter(translation_stash),
+                                                           [is_translated](const auto& x) { return !is_translated(x); });
+  progress += std::distance(last_not_missed, due_end);
+  due_end = inflight_tag_check.erase(last_not_missed, due_end);
 
   // Perform tag checks
   auto do_handle_miss = [this](const auto& pkt) {
@@ -571,9 +743,7 @@ long CACHE::operate()
     return this->handle_miss(pkt); // Treat writes (that is, stores) like reads
   };
   champsim::bandwidth tag_check_bw{MAX_TAG};
-  auto [tag_check_ready_begin, tag_check_ready_end] =
-      champsim::get_span_p(std::begin(inflight_tag_check), std::end(inflight_tag_check), tag_check_bw,
-                           [is_ready, is_translated](const auto& pkt) { return is_ready(pkt) && is_translated(pkt); });
+  auto [tag_check_ready_begin, tag_check_ready_end] = champsim::get_span(std::begin(inflight_tag_check), due_end, tag_check_bw);
   auto hits_end = std::stable_partition(tag_check_ready_begin, tag_check_ready_end, [this](const auto& pkt) { return this->try_hit(pkt); });
   auto finish_tag_check_end = std::stable_partition(hits_end, tag_check_ready_end, do_handle_miss);
   tag_check_bw.consume(std::distance(tag_check_ready_begin, finish_tag_check_end));
@@ -581,6 +751,12 @@ long CACHE::operate()
 
   impl_prefetcher_cycle_operate();
 
+  if constexpr (champsim::record_heatmap) {
+    if ((current_time.time_since_epoch() / clock_period) % champsim::set_way_heatmap::INTERVAL_CYCLES == 0) {
+      heatmap->write_interval(NAME + ".heatmap.csv");
+    }
+  }
+
   if constexpr (champsim::debug_print) {
     fmt::print("[{}] {} cycle completed: {} tags checked: {} remaining: {} stash consumed: {} remaining: {} channel consumed: {} pq consumed {} unused consume "
                "bw {}\n",
@@ -595,7 +771,12 @@ long CACHE::operate()
 uint64_t CACHE::get_set(uint64_t address) const { return static_cast<uint64_t>(get_set_index(champsim::address{address})); }
 // LCOV_EXCL_STOP
 
-long CACHE::get_set_index(champsim::address address) const { return address.slice(champsim::dynamic_extent{OFFSET_BITS, champsim::lg2(NUM_SET)}).to<long>(); }
+long CACHE::get_set_index(champsim::address address) const
+{
+  return static_cast<long>((address.to<uint64_t>() >> champsim::to_underlying(OFFSET_BITS)) & SET_INDEX_MASK);
+}
+
+bool CACHE::is_sampled_set(champsim::address address) const { return (get_set_index(address) % SET_SAMPLE_STRIDE) == 0; }
 
 template <typename It>
 std::pair<It, It> get_span(It anchor, typename std::iterator_traits<It>::difference_type set_idx, typename std::iterator_traits<It>::difference_type num_way)
@@ -641,27 +822,123 @@ long CACHE::invalidate_entry(champsim::address inval_addr)
 
 bool CACHE::prefetch_line(champsim::address pf_addr, bool fill_this_level, uint32_t prefetch_metadata)
 {
-  ++sim_stats.pf_requested;
+  return issue_prefetch(champsim::prefetch_request{pf_addr, fill_this_level, prefetch_metadata}, false);
+}
+
+bool CACHE::issue_prefetch(const champsim::prefetch_request& request, bool duplicate)
+{
+  // Physical prefetches to sets outside of the sample are discarded here, virtual ones are discarded at the tag check once they are translated
+  const auto sample_weight = virtual_prefetch ? 1u : SET_SAMPLE_STRIDE;
+  if (!virtual_prefetch && !is_sampled_set(request.address)) {
+    return true;
+  }
+
+  if (prefetch_shadow.has_value()) {
+    shadow_directories.at(prefetch_shadow.value()).prefetch(shadow_key(request.address), !virtual_prefetch && is_resident(request.address), sample_weight);
+    return true;
+  }
+
+  sim_stats.pf_requested += sample_weight;
+
+  if (duplicate || is_redundant_prefetch(request.address)) {
+    sim_stats.pf_filtered += sample_weight;
+    return true;
+  }
 
   if (std::size(internal_PQ) >= PQ_SIZE) {
-    ++sim_stats.pf_dropped;
+    sim_stats.pf_dropped += sample_weight;
     return false;
   }
 
   request_type pf_packet;
   pf_packet.type = access_type::PREFETCH;
-  pf_packet.pf_metadata = prefetch_metadata;
+  pf_packet.pf_metadata = request.metadata;
   pf_packet.cpu = cpu;
-  pf_packet.address = pf_addr;
-  pf_packet.v_address = virtual_prefetch ? pf_addr : champsim::address{};
+  pf_packet.address = request.address;
+  pf_packet.v_address = virtual_prefetch ? request.address : champsim::address{};
   pf_packet.is_translated = !virtual_prefetch;
 
-  internal_PQ.emplace_back(pf_packet, true, !fill_this_level);
-  ++sim_stats.pf_issued;
+  internal_PQ.emplace_back(pf_packet, true, !request.fill_this_level);
+  if (pf_attribution.has_value() && pf_trigger_ip.has_value()) {
+    internal_PQ.back().pf_trigger = pf_attribution->issue(pf_trigger_ip.value(), sample_weight);
+  }
+  sim_stats.pf_issued += sample_weight;
+  if (pf_filter.has_value()) {
+    pf_filter->insert(champsim::block_number{request.address}.to<uint64_t>());
+  }
 
   return true;
 }
 
+bool CACHE::is_resident(champsim::address address) const
+{
+  auto [set_begin, set_end] = get_available_set_span(address);
+  return std::any_of(set_begin, set_end, [matcher = matches_address(address)](const auto& x) { return x.valid && matcher(x); });
+}
+
+bool CACHE::is_redundant_prefetch(champsim::address pf_addr) const
+{
+  if (!pf_filter.has_value()) {
+    return false;
+  }
+
+  // Resident blocks can only be found by physical address
+  if (!virtual_prefetch && is_resident(pf_addr)) {
+    return true;
+  }
+
+  // The queues are only searched if both filter bits are set. An erase may have cleared a bit of a pending block, which then goes through as a
+  // duplicate that the MSHR merges.
+  champsim::block_number block{pf_addr};
+  if (!pf_filter->maybe_contains(block.to<uint64_t>())) {
+    return false;
+  }
+
+  auto is_pending = [block, virt = virtual_prefetch](const auto& entry) { return champsim::block_number{virt ? entry.v_address : entry.address} == block; };
+  return std::any_of(std::begin(internal_PQ), std::end(internal_PQ), is_pending)
+         || std::any_of(std::begin(inflight_tag_check), std::end(inflight_tag_check), is_pending)
+         || std::any_of(std::begin(translation_stash), std::end(translation_stash), is_pending)
+         || std::any_of(std::begin(MSHR), std::end(MSHR), is_pending);
+}
+
+std::size_t CACHE::prefetch_lines(const std::vector<champsim::prefetch_request>& requests)
+{
+  // Find the requests that repeat a block from earlier in the batch by sorting their positions by block, rather than comparing every pair
+  std::vector<std::size_t> order(std::size(requests));
+  std::iota(std::begin(order), std::end(order), std::size_t{0});
+  auto block_of = [&requests](std::size_t idx) { return champsim::block_number{requests[idx].address}; };
+  std::stable_sort(std::begin(order), std::end(order), [&block_of](auto lhs, auto rhs) { return block_of(lhs) < block_of(rhs); });
+
+  std::vector<bool> duplicate(std::size(requests), false);
+  for (auto it = std::next(std::begin(order), std::empty(order) ? 0 : 1); it != std::end(order); ++it) {
+    duplicate[*it] = (block_of(*it) == block_of(*std::prev(it)));
+  }
+
+  std::size_t accepted = 0;
+  bool all_accepted = true;
+  for (std::size_t idx = 0; idx < std::size(requests); ++idx) {
+    all_accepted = issue_prefetch(requests[idx], duplicate[idx]) && all_accepted;
+    accepted += all_accepted ? 1 : 0;
+  }
+
+  return accepted;
+}
+
+std::size_t CACHE::add_shadow_directory()
+{
+  shadow_directories.emplace_back(std::max<std::size_t>(NUM_SET / SET_SAMPLE_STRIDE, 1), NUM_WAY);
+  return std::size(shadow_directories) - 1;
+}
+
+void CACHE::divert_prefetches(std::optional<std::size_t> shadow) { prefetch_shadow = shadow; }
+
+uint64_t CACHE::shadow_key(champsim::address address) const
+{
+  // Physical blocks in the sample are all in sets that are multiples of the stride, so the quotient indexes the shadow directory densely
+  auto block = address.slice_upper(OFFSET_BITS).to<uint64_t>();
+  return virtual_prefetch ? block : block / SET_SAMPLE_STRIDE;
+}
+
 // LCOV_EXCL_START exclude deprecated function
 bool CACHE::prefetch_line(uint64_t pf_addr, bool fill_this_level, uint32_t prefetch_metadata)
 {
@@ -699,8 +976,16 @@ void CACHE::finish_packet(const response_type& packet)
   std::iter_swap(mshr_entry, first_unreturned);
 }
 
+uint64_t CACHE::translation_key(champsim::address v_address) { return champsim::page_number{v_address}.to<uint64_t>(); }
+
 void CACHE::finish_translation(const response_type& packet)
 {
+  // Skip the search entirely if nothing is waiting on this page
+  auto waiting = untranslated_pages.find(translation_key(packet.v_address));
+  if (waiting == std::end(untranslated_pages)) {
+    return;
+  }
+
   auto matches_vpage = [page_num = champsim::page_number{packet.v_address}](const auto& entry) {
     return (champsim::page_number{entry.v_address} == page_num) && !entry.is_translated;
   };
@@ -708,6 +993,9 @@ void CACHE::finish_translation(const response_type& packet)
     [[maybe_unused]] auto old_address = entry.address;
     entry.address = champsim::address{champsim::splice(p_page, champsim::page_offset{entry.v_address})}; // translated address
     entry.is_translated = true;                                                                          // This entry is now translated
+    if (!entry.translate_issued) {
+      --this->translations_to_retry; // Another entry's request for the page covered this one
+    }
 
     if constexpr (champsim::debug_print) {
       fmt::print("[{}_TRANSLATE] finish_translation old: {} paddr: {} vaddr: {} type: {} cycle: {}\n", this->NAME, old_address, entry.address, entry.v_address,
@@ -719,16 +1007,21 @@ void CACHE::finish_translation(const response_type& packet)
   auto finish_begin = std::find_if_not(std::begin(translation_stash), std::end(translation_stash), [](const auto& x) { return x.is_translated; });
   auto finish_end = std::stable_partition(finish_begin, std::end(translation_stash), matches_vpage);
   std::for_each(finish_begin, finish_end, mark_translated);
+  auto remaining = waiting->second - static_cast<std::size_t>(std::distance(finish_begin, finish_end));
 
-  // Find all packets that match the page of the returned packet
-  for (auto& entry : inflight_tag_check) {
-    if (matches_vpage(entry)) {
-      mark_translated(entry);
+  // Find all packets that match the page of the returned packet, stopping once every waiting entry has been found
+  for (auto it = std::begin(inflight_tag_check); remaining > 0 && it != std::end(inflight_tag_check); ++it) {
+    if (matches_vpage(*it)) {
+      mark_translated(*it);
+      --remaining;
     }
   }
+
+  assert(remaining == 0);
+  untranslated_pages.erase(waiting);
 }
 
-void CACHE::issue_translation(tag_lookup_type& q_entry) const
+bool CACHE::issue_translation(tag_lookup_type& q_entry) const
 {
   if (!q_entry.translate_issued && !q_entry.is_translated) {
     request_type fwd_pkt;
@@ -754,6 +1047,8 @@ void CACHE::issue_translation(tag_lookup_type& q_entry) const
       }
     }
   }
+
+  return q_entry.is_translated || q_entry.translate_issued;
 }
 
 std::size_t CACHE::get_mshr_occupancy() const { return std::size(MSHR); }
@@ -906,6 +1201,11 @@ void CACHE::impl_replacement_final_stats() const { repl_module_pimpl->impl_repla
 
 void CACHE::initialize()
 {
+  // Only the sampled sets send requests down, so each one stands for a request from every set in its stride
+  if (lower_level != nullptr) {
+    lower_level->sample_weight = SET_SAMPLE_STRIDE;
+  }
+
   impl_prefetcher_initialize();
   impl_initialize_replacement();
 }
@@ -918,9 +1218,25 @@ void CACHE::begin_phase()
   new_roi_stats.name = NAME;
   new_sim_stats.name = NAME;
 
+  if (stack_monitor.has_value()) {
+    new_roi_stats.stack_position_hits.resize(stack_monitor->ways());
+    new_sim_stats.stack_position_hits.resize(stack_monitor->ways());
+  }
+
   roi_stats = new_roi_stats;
   sim_stats = new_sim_stats;
 
+  if (pf_attribution.has_value()) {
+    pf_attribution->clear();
+  }
+  for (auto& shadow : shadow_directories) {
+    shadow.stats = {};
+  }
+
+  if constexpr (champsim::record_heatmap) {
+    heatmap->begin_phase();
+  }
+
   for (auto* ul : upper_levels) {
     channel_type::stats_type ul_new_roi_stats;
     channel_type::stats_type ul_new_sim_stats;
@@ -932,6 +1248,12 @@ void CACHE::begin_phase()
 void CACHE::end_phase(unsigned finished_cpu)
 {
   finished_cpu = finished_cpu;
+
+  // Every core's end of phase reaches every cache, so the heatmap waits for the last one
+  if constexpr (champsim::record_heatmap) {
+    heatmap->end_phase(NAME + ".heatmap.csv", NUM_CPUS);
+  }
+
   roi_stats.total_miss_latency_cycles = sim_stats.total_miss_latency_cycles;
 
   roi_stats.hits = sim_stats.hits;
@@ -941,11 +1263,22 @@ void CACHE::end_phase(unsigned finished_cpu)
 
   roi_stats.pf_requested = sim_stats.pf_requested;
   roi_stats.pf_dropped = sim_stats.pf_dropped;
+  roi_stats.pf_filtered = sim_stats.pf_filtered;
   roi_stats.pf_issued = sim_stats.pf_issued;
   roi_stats.pf_useful = sim_stats.pf_useful;
   roi_stats.pf_useless = sim_stats.pf_useless;
   roi_stats.pf_fill = sim_stats.pf_fill;
   roi_stats.pf_late = sim_stats.pf_late;
+  if (pf_attribution.has_value()) {
+    roi_stats.pf_by_ip = pf_attribution->top();
+  }
+  roi_stats.pf_shadow.clear();
+  for (const auto& shadow : shadow_directories) {
+    roi_stats.pf_shadow.push_back(shadow.stats);
+  }
+
+  roi_stats.stack_position_hits = sim_stats.stack_position_hits;
+  roi_stats.stack_misses = sim_stats.stack_misses;
 
   for (auto* ul : upper_levels) {
     ul->roi_stats.RQ_ACCESS = ul->sim_stats.RQ_ACCESS;
@@ -1024,3 +1357,119 @@ auto CACHE::get_available_set_span(champsim::address address) const -> std::pair
 }
 
 // LCOV_EXCL_STOP
+
+namespace
+{
+constexpr std::array<char, 8> snapshot_magic{'C', 'S', 'C', 'A', 'C', 'H', 'E', '2'};
+constexpr uint8_t snapshot_dirty_flag = 0x1;
+constexpr uint8_t snapshot_prefetch_flag = 0x2;
+
+template <typename T>
+void write_snapshot_field(std::ostream& stream, T value)
+{
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+template <typename T>
+T read_snapshot_field(std::istream& stream)
+{
+  T value{};
+  stream.read(reinterpret_cast<char*>(&value), sizeof(T)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  if (!stream) {
+    throw std::runtime_error{"Cache snapshot is truncated"};
+  }
+  return value;
+}
+} // namespace
+
+void CACHE::save_snapshot(std::ostream& stream) const
+{
+  stream.write(std::data(snapshot_magic), std::size(snapshot_magic));
+  write_snapshot_field(stream, static_cast<uint32_t>(std::size(NAME)));
+  stream.write(std::data(NAME), static_cast<std::streamsize>(std::size(NAME)));
+  write_snapshot_field(stream, NUM_SET);
+  write_snapshot_field(stream, NUM_WAY);
+  write_snapshot_field(stream, static_cast<uint32_t>(champsim::to_underlying(OFFSET_BITS)));
+
+  // Blocks are written set by set, from least to most recently used, so that a load replays the fills of each set in the same order
+  write_snapshot_field(stream, static_cast<uint64_t>(std::count_if(std::cbegin(block), std::cend(block), [](const auto& x) { return x.valid; })));
+  std::vector<std::size_t> set_order(NUM_WAY);
+  for (std::size_t set_begin = 0; set_begin < std::size(block); set_begin += NUM_WAY) {
+    std::iota(std::begin(set_order), std::end(set_order), set_begin);
+    std::sort(std::begin(set_order), std::end(set_order), [this](auto lhs, auto rhs) { return block_last_use.at(lhs) < block_last_use.at(rhs); });
+    for (auto idx : set_order) {
+      auto blk = std::next(std::cbegin(block), static_cast<long>(idx));
+      if (blk->valid) {
+        write_snapshot_field(stream, blk->address.to<uint64_t>());
+        write_snapshot_field(stream, v_address_of(blk).to<uint64_t>());
+        write_snapshot_field(stream, data_of(blk).to<uint64_t>());
+        write_snapshot_field(stream, blk->pf_metadata);
+        write_snapshot_field(stream, static_cast<uint8_t>((blk->dirty ? snapshot_dirty_flag : 0) | (blk->prefetch ? snapshot_prefetch_flag : 0)));
+        write_snapshot_field(stream, static_cast<uint32_t>(idx - set_begin));
+        write_snapshot_field(stream, block_cpu.at(idx));
+      }
+    }
+  }
+}
+
+void CACHE::load_snapshot(std::istream& stream)
+{
+  std::array<char, std::size(snapshot_magic)> magic{};
+  stream.read(std::data(magic), std::size(magic));
+  if (!stream || magic != snapshot_magic) {
+    throw std::runtime_error{"Not a cache snapshot"};
+  }
+
+  std::string name(read_snapshot_field<uint32_t>(stream), '\0');
+  stream.read(std::data(name), static_cast<std::streamsize>(std::size(name)));
+  if (!stream) {
+    throw std::runtime_error{"Cache snapshot is truncated"};
+  }
+  if (name != NAME) {
+    throw std::invalid_argument{fmt::format("A snapshot of {} cannot be loaded into {}", name, NAME)};
+  }
+
+  const auto snapshot_sets = read_snapshot_field<uint32_t>(stream);
+  const auto snapshot_ways = read_snapshot_field<uint32_t>(stream);
+  const auto snapshot_offset_bits = read_snapshot_field<uint32_t>(stream);
+  if (snapshot_sets != NUM_SET || snapshot_ways != NUM_WAY || snapshot_offset_bits != champsim::to_underlying(OFFSET_BITS)) {
+    throw std::invalid_argument{fmt::format("A snapshot of {} with {} sets, {} ways, and {} offset bits does not fit {} sets, {} ways, and {} offset bits",
+                                            name, snapshot_sets, snapshot_ways, snapshot_offset_bits, NUM_SET, NUM_WAY, champsim::to_underlying(OFFSET_BITS))};
+  }
+
+  std::fill(std::begin(block), std::end(block), BLOCK{});
+  std::fill(std::begin(block_last_use), std::end(block_last_use), 0);
+
+  const auto num_blocks = read_snapshot_field<uint64_t>(stream);
+  for (uint64_t i = 0; i < num_blocks; ++i) {
+    BLOCK loaded{};
+    loaded.valid = true;
+    loaded.address = champsim::address{read_snapshot_field<uint64_t>(stream)};
+    const champsim::address loaded_v_address{read_snapshot_field<uint64_t>(stream)};
+    const champsim::address loaded_data{read_snapshot_field<uint64_t>(stream)};
+    loaded.pf_metadata = read_snapshot_field<uint32_t>(stream);
+    const auto flags = read_snapshot_field<uint8_t>(stream);
+    loaded.dirty = (flags & snapshot_dirty_flag) != 0;
+    loaded.prefetch = (flags & snapshot_prefetch_flag) != 0;
+    const auto way_idx = read_snapshot_field<uint32_t>(stream);
+    const auto loaded_cpu = read_snapshot_field<uint32_t>(stream);
+    if (way_idx >= NUM_WAY) {
+      throw std::runtime_error{"Cache snapshot names a way outside of the set"};
+    }
+
+    if (!is_sampled_set(loaded.address)) {
+      continue;
+    }
+
+    // Replay the fill, so that the replacement policy sees the blocks of each set in their recorded order
+    const auto set_idx = get_set_index(loaded.address);
+    const auto block_idx = static_cast<std::size_t>(set_idx) * NUM_WAY + way_idx;
+    auto way = std::next(std::begin(block), static_cast<long>(block_idx));
+    impl_replacement_cache_fill(loaded_cpu, set_idx, way_idx, module_address(loaded.address, loaded_v_address), champsim::address{}, champsim::address{},
+                                loaded.prefetch ? access_type::PREFETCH : access_type::LOAD);
+    *way = loaded;
+    store_payload(way, loaded_v_address, loaded_data);
+    block_cpu.at(block_idx) = loaded_cpu;
+    block_last_use.at(block_idx) = ++block_use_clock;
+  }
+}
@@ -1,19 +1,50 @@
 #include "cache_stats.h"
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
+
 cache_stats operator-(cache_stats lhs, cache_stats rhs)
 {
   cache_stats result;
   result.pf_requested = lhs.pf_requested - rhs.pf_requested;
   result.pf_dropped = lhs.pf_dropped - rhs.pf_dropped;
+  result.pf_filtered = lhs.pf_filtered - rhs.pf_filtered;
   result.pf_issued = lhs.pf_issued - rhs.pf_issued;
   result.pf_useful = lhs.pf_useful - rhs.pf_useful;
   result.pf_useless = lhs.pf_useless - rhs.pf_useless;
   result.pf_fill = lhs.pf_fill - rhs.pf_fill;
   result.pf_late = lhs.pf_late -rhs.pf_late;
 
+  // The attribution table is cleared at the start of each phase, so the later operand already holds only its own counts
+  result.pf_by_ip = lhs.pf_by_ip;
+  result.pf_shadow = lhs.pf_shadow;
+
   result.hits = lhs.hits - rhs.hits;
   result.misses = lhs.misses - rhs.misses;
 
   result.total_miss_latency_cycles = lhs.total_miss_latency_cycles - rhs.total_miss_latency_cycles;
+
+  result.stack_position_hits = lhs.stack_position_hits;
+  rhs.stack_position_hits.resize(std::size(lhs.stack_position_hits));
+  std::transform(std::cbegin(lhs.stack_position_hits), std::cend(lhs.stack_position_hits), std::cbegin(rhs.stack_position_hits),
+                 std::begin(result.stack_position_hits), std::minus<>{});
+  result.stack_misses = lhs.stack_misses - rhs.stack_misses;
+  return result;
+}
+
+std::vector<long> lru_hit_curve(const cache_stats& stats)
+{
+  std::vector<long> result;
+  std::partial_sum(std::cbegin(stats.stack_position_hits), std::cend(stats.stack_position_hits), std::back_inserter(result));
+  return result;
+}
+
+std::vector<long> lru_miss_curve(const cache_stats& stats)
+{
+  auto result = lru_hit_curve(stats);
+  const auto total_accesses = (std::empty(result) ? 0 : result.back()) + stats.stack_misses;
+  std::transform(std::cbegin(result), std::cend(result), std::begin(result), [total_accesses](auto hits) { return total_accesses - hits; });
   return result;
 }
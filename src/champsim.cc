@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <fstream>
 #include <numeric>
 #include <vector>
 #include <string>
@@ -67,6 +68,10 @@ phase_stats do_phase(const phase_info& phase, environment& env, std::vector<trac
   auto operables = env.operable_view();
   auto [phase_name, is_warmup, length, trace_index, trace_names] = phase;
   global_trace_name = trace_names[0];
+  for (O3_CPU& cpu : env.cpu_view()) {
+    lookahead::attach(cpu.cpu, &traces.at(trace_index.at(cpu.cpu)));
+  }
+
   // Initialize phase
   for (champsim::operable& op : operables) {
     op.warmup = is_warmup;
@@ -182,19 +187,47 @@ phase_stats do_phase(const phase_info& phase, environment& env, std::vector<trac
   return stats;
 }
 
+std::string cache_snapshot_file(const std::string& dir, const CACHE& cache) { return dir + "/" + cache.NAME + ".snapshot"; }
+
+void load_cache_snapshots(environment& env, const std::string& dir)
+{
+  for (CACHE& cache : env.cache_view()) {
+    std::ifstream snapshot{cache_snapshot_file(dir, cache), std::ios::binary};
+    if (snapshot) {
+      cache.load_snapshot(snapshot);
+    } else {
+      fmt::print("WARNING: no snapshot for {} in {}, it will start empty\n", cache.NAME, dir);
+    }
+  }
+}
+
+void save_cache_snapshots(environment& env, const std::string& dir)
+{
+  for (CACHE& cache : env.cache_view()) {
+    std::ofstream snapshot{cache_snapshot_file(dir, cache), std::ios::binary};
+    cache.save_snapshot(snapshot);
+  }
+}
+
 // simulation entry point
-std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases, std::vector<tracereader>& traces)
+std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases, std::vector<tracereader>& traces, const cache_snapshot_paths& snapshots)
 {
   for (champsim::operable& op : env.operable_view()) {
     op.initialize();
   }
 
+  if (!std::empty(snapshots.load_from)) {
+    load_cache_snapshots(env, snapshots.load_from);
+  }
+
   champsim::chrono::clock global_clock;
   std::vector<phase_stats> results;
   for (auto phase : phases) {
     auto stats = do_phase(phase, env, traces, global_clock);
     if (!phase.is_warmup) {
       results.push_back(stats);
+    } else if (!std::empty(snapshots.save_to)) {
+      save_cache_snapshots(env, snapshots.save_to);
     }
   }
 
@@ -16,29 +16,222 @@
 
 #include "channel.h"
 
+#include <algorithm>
 #include <cassert>
 #include <fmt/core.h>
 
 #include "cache.h"
 #include "champsim.h"
 #include "instruction.h"
+#include "util/algorithm.h" // for set_union_into
 #include "util/to_underlying.h" // for to_underlying
 
 champsim::channel::channel(std::size_t rq_size, std::size_t pq_size, std::size_t wq_size, champsim::data::bits offset_bits, bool match_offset)
-    : RQ_SIZE(rq_size), PQ_SIZE(pq_size), WQ_SIZE(wq_size), OFFSET_BITS(offset_bits), match_offset_bits(match_offset)
+    : RQ_SIZE(rq_size), PQ_SIZE(pq_size), WQ_SIZE(wq_size), OFFSET_BITS(offset_bits), match_offset_bits(match_offset), RQ(offset_bits), PQ(offset_bits),
+      WQ(match_offset ? champsim::data::bits{} : offset_bits)
 {
+  // Unbounded queues grow on demand, so only preallocate those with a configured size
+  for (auto [queue, size] : {std::pair{&RQ, RQ_SIZE}, std::pair{&PQ, PQ_SIZE}, std::pair{&WQ, WQ_SIZE}}) {
+    if (size != std::numeric_limits<std::size_t>::max()) {
+      queue->reserve(size);
+    }
+  }
+}
+
+std::size_t champsim::channel::request_queue::home(uint64_t block) const
+{
+  // splitmix64 finalizer
+  block ^= block >> 30;
+  block *= 0xbf58476d1ce4e5b9ull;
+  block ^= block >> 27;
+  block *= 0x94d049bb133111ebull;
+  block ^= block >> 31;
+  return static_cast<std::size_t>(block) & (std::size(slots) - 1);
+}
+
+std::size_t champsim::channel::request_queue::find_slot(uint64_t block) const
+{
+  // Returns the slot holding the block, or the empty slot that ends its probe run
+  const auto mask = std::size(slots) - 1;
+  auto pos = home(block);
+  while (slots[pos].count != 0 && slots[pos].block != block) {
+    pos = (pos + 1) & mask;
+  }
+  return pos;
+}
+
+std::size_t champsim::channel::request_queue::position_of(uint64_t seq) const
+{
+  auto found = std::lower_bound(std::begin(seqs), std::end(seqs), seq);
+  assert(found != std::end(seqs) && *found == seq);
+  return static_cast<std::size_t>(std::distance(std::begin(seqs), found));
+}
+
+void champsim::channel::request_queue::rehash(std::size_t num_slots)
+{
+  std::vector<index_slot> old_slots(num_slots);
+  std::swap(slots, old_slots);
+  for (const auto& s : old_slots) {
+    if (s.count != 0) {
+      slots[find_slot(s.block)] = s;
+    }
+  }
+}
+
+void champsim::channel::request_queue::remove_slot(std::size_t pos)
+{
+  // Backward-shift deletion: pull later members of the probe run into the hole, so that lookups need no tombstones
+  const auto mask = std::size(slots) - 1;
+  for (auto next = (pos + 1) & mask; slots[next].count != 0; next = (next + 1) & mask) {
+    auto desired = home(slots[next].block);
+    if (((next - desired) & mask) >= ((next - pos) & mask)) {
+      slots[pos] = slots[next];
+      pos = next;
+    }
+  }
+  slots[pos] = index_slot{};
+  --num_blocks;
+}
+
+void champsim::channel::request_queue::reserve(std::size_t new_capacity)
+{
+  base_type::reserve(new_capacity);
+  seqs.reserve(new_capacity);
+
+  // Keep the table at most half full while the queue is within its capacity
+  std::size_t num_slots = 8;
+  while (num_slots < 2 * new_capacity) {
+    num_slots <<= 1;
+  }
+  if (num_slots > std::size(slots)) {
+    rehash(num_slots);
+  }
+}
+
+void champsim::channel::request_queue::index_insert()
+{
+  // Unbounded queues grow the table on demand
+  if (2 * (num_blocks + 1) > std::size(slots)) {
+    rehash(std::max<std::size_t>(2 * std::size(slots), 8));
+  }
+
+  auto seq = next_seq++;
+  seqs.push_back(seq);
+
+  auto& s = slots[find_slot(key(back().address))];
+  if (s.count == 0) {
+    s.block = key(back().address);
+    s.oldest = seq;
+    ++num_blocks;
+  }
+  ++s.count;
+}
+
+void champsim::channel::request_queue::index_erase(std::size_t idx)
+{
+  const auto block = key((*this)[idx].address);
+  auto pos = find_slot(block);
+  auto& s = slots[pos];
+  assert(s.count != 0);
+
+  if (--s.count == 0) {
+    remove_slot(pos);
+  } else if (s.oldest == seqs[idx]) {
+    // Another entry in the block remains. This only happens when packets that cannot merge share a block, so the walk is short.
+    auto next = std::find_if(std::next(std::cbegin(*this), static_cast<difference_type>(idx) + 1), std::cend(*this),
+                             [block, this](const auto& pkt) { return this->key(pkt.address) == block; });
+    assert(next != std::cend(*this));
+    s.oldest = seqs[static_cast<std::size_t>(std::distance(std::cbegin(*this), next))];
+  }
+}
+
+void champsim::channel::request_queue::push_back(const request& pkt)
+{
+  base_type::push_back(pkt);
+  index_insert();
+}
+
+void champsim::channel::request_queue::push_back(request&& pkt)
+{
+  base_type::push_back(std::move(pkt));
+  index_insert();
+}
+
+void champsim::channel::request_queue::pop_front()
+{
+  index_erase(0);
+  seqs.pop_front();
+  base_type::pop_front();
+}
+
+void champsim::channel::request_queue::pop_back()
+{
+  index_erase(size() - 1);
+  seqs.pop_back();
+  base_type::pop_back();
+}
+
+void champsim::channel::request_queue::clear()
+{
+  std::fill(std::begin(slots), std::end(slots), index_slot{});
+  num_blocks = 0;
+  seqs.clear();
+  base_type::clear();
+}
+
+auto champsim::channel::request_queue::erase(const_iterator pos) -> iterator { return erase(pos, std::next(pos)); }
+
+auto champsim::channel::request_queue::erase(const_iterator first, const_iterator last) -> iterator
+{
+  const auto first_idx = std::distance(std::cbegin(*this), first);
+  const auto last_idx = std::distance(std::cbegin(*this), last);
+  for (auto idx = first_idx; idx != last_idx; ++idx) {
+    index_erase(static_cast<std::size_t>(idx));
+  }
+  seqs.erase(std::next(std::cbegin(seqs), first_idx), std::next(std::cbegin(seqs), last_idx));
+  return base_type::erase(first, last);
+}
+
+std::size_t champsim::channel::request_queue::block_count(champsim::address addr) const
+{
+  if (std::empty(slots)) {
+    return 0;
+  }
+  return slots[find_slot(key(addr))].count;
+}
+
+auto champsim::channel::request_queue::find_first(champsim::address addr) -> iterator
+{
+  if (std::empty(slots)) {
+    return end();
+  }
+  const auto& s = slots[find_slot(key(addr))];
+  if (s.count == 0) {
+    return end();
+  }
+  return std::next(begin(), static_cast<difference_type>(position_of(s.oldest)));
+}
+
+auto champsim::channel::request_queue::find_first(champsim::address addr) const -> const_iterator
+{
+  if (std::empty(slots)) {
+    return end();
+  }
+  const auto& s = slots[find_slot(key(addr))];
+  if (s.count == 0) {
+    return end();
+  }
+  return std::next(begin(), static_cast<difference_type>(position_of(s.oldest)));
 }
 
 template <typename Iter, typename F>
-bool do_collision_for(Iter begin, Iter end, champsim::channel::request_type& packet, champsim::data::bits shamt, F&& func)
+bool do_collision_for(Iter found, Iter end, champsim::channel::request_type& packet, F&& func)
 {
   // We make sure that both merge packet address have been translated. If
   // not this can happen: package with address virtual and physical X
   // (not translated) is inserted, package with physical address
   // (already translated) X.
-  if (auto found =
-          std::find_if(begin, end, [match = packet.address.slice_upper(shamt), shamt](const auto& x) { return x.address.slice_upper(shamt) == match; });
-      found != end && packet.is_translated == found->is_translated) {
+  if (found != end && packet.is_translated == found->is_translated) {
     func(packet, *found);
     return true;
   }
@@ -47,36 +240,38 @@ bool do_collision_for(Iter begin, Iter end, champsim::channel::request_type& pac
 }
 
 template <typename Iter>
-bool do_collision_for_merge(Iter begin, Iter end, champsim::channel::request_type& packet, champsim::data::bits shamt)
+bool do_collision_for_merge(Iter found, Iter end, champsim::channel::request_type& packet)
 {
-  return do_collision_for(begin, end, packet, shamt, [](champsim::channel::request_type& source, champsim::channel::request_type& destination) {
+  return do_collision_for(found, end, packet, [](champsim::channel::request_type& source, champsim::channel::request_type& destination) {
     destination.response_requested |= source.response_requested;
-    auto instr_copy = std::move(destination.instr_depend_on_me);
-
-    std::set_union(std::begin(instr_copy), std::end(instr_copy), std::begin(source.instr_depend_on_me), std::end(source.instr_depend_on_me),
-                   std::back_inserter(destination.instr_depend_on_me));
+    champsim::set_union_into(destination.instr_depend_on_me, source.instr_depend_on_me);
   });
 }
 
 template <typename Iter>
-bool do_collision_for_return(Iter begin, Iter end, champsim::channel::request_type& packet, champsim::data::bits shamt,
-                             std::deque<champsim::channel::response_type>& returned)
+bool do_collision_for_return(Iter found, Iter end, champsim::channel::request_type& packet, champsim::ring_buffer<champsim::channel::response_type>& returned)
 {
-  return do_collision_for(begin, end, packet, shamt, [&](champsim::channel::request_type& source, champsim::channel::request_type& destination) {
+  return do_collision_for(found, end, packet, [&](champsim::channel::request_type& source, champsim::channel::request_type& destination) {
     if (source.response_requested) {
-      returned.emplace_back(source.address, source.v_address, destination.data, destination.pf_metadata, source.instr_depend_on_me);
+      returned.emplace_back(source.address, source.v_address, destination.data, destination.pf_metadata, std::move(source.instr_depend_on_me));
     }
   });
 }
 
 void champsim::channel::check_collision()
 {
-  auto write_shamt = match_offset_bits ? champsim::data::bits{} : OFFSET_BITS;
-  auto read_shamt = OFFSET_BITS;
+  // Packets are only appended, and each call checks every packet through the end of the queue, so the unchecked packets are at the back.
+  auto first_unchecked = [](auto& queue) {
+    return std::find_if(std::rbegin(queue), std::rend(queue), [](const auto& pkt) { return pkt.forward_checked; }).base();
+  };
+
+  // Each queue indexes its packets by the bits that a collision must match: the WQ by the full address if match_offset_bits is set, the
+  // others by block. A packet may only merge with an older packet, so the oldest match counts only if it comes before the packet itself.
+  auto earlier_match = [](auto& queue, auto it) { return std::min(queue.find_first(it->address), it); };
 
   // Check WQ for duplicates, merging if they are found
-  for (auto wq_it = std::find_if(std::begin(WQ), std::end(WQ), std::not_fn(&request_type::forward_checked)); wq_it != std::end(WQ);) {
-    if (do_collision_for_merge(std::begin(WQ), wq_it, *wq_it, write_shamt)) {
+  for (auto wq_it = first_unchecked(WQ); wq_it != std::end(WQ);) {
+    if (do_collision_for_merge(earlier_match(WQ, wq_it), wq_it, *wq_it)) {
       sim_stats.WQ_MERGED++;
       wq_it = WQ.erase(wq_it);
     } else {
@@ -86,11 +281,11 @@ void champsim::channel::check_collision()
   }
 
   // Check RQ for forwarding from WQ (return if found), then for duplicates (merge if found)
-  for (auto rq_it = std::find_if(std::begin(RQ), std::end(RQ), std::not_fn(&request_type::forward_checked)); rq_it != std::end(RQ);) {
-    if (do_collision_for_return(std::begin(WQ), std::end(WQ), *rq_it, write_shamt, returned)) {
+  for (auto rq_it = first_unchecked(RQ); rq_it != std::end(RQ);) {
+    if (do_collision_for_return(WQ.find_first(rq_it->address), std::end(WQ), *rq_it, returned)) {
       sim_stats.WQ_FORWARD++;
       rq_it = RQ.erase(rq_it);
-    } else if (do_collision_for_merge(std::begin(RQ), rq_it, *rq_it, read_shamt)) {
+    } else if (do_collision_for_merge(earlier_match(RQ, rq_it), rq_it, *rq_it)) {
       sim_stats.RQ_MERGED++;
       rq_it = RQ.erase(rq_it);
     } else {
@@ -100,11 +295,11 @@ void champsim::channel::check_collision()
   }
 
   // Check PQ for forwarding from WQ (return if found), then for duplicates (merge if found)
-  for (auto pq_it = std::find_if(std::begin(PQ), std::end(PQ), std::not_fn(&request_type::forward_checked)); pq_it != std::end(PQ);) {
-    if (do_collision_for_return(std::begin(WQ), std::end(WQ), *pq_it, write_shamt, returned)) {
+  for (auto pq_it = first_unchecked(PQ); pq_it != std::end(PQ);) {
+    if (do_collision_for_return(WQ.find_first(pq_it->address), std::end(WQ), *pq_it, returned)) {
       sim_stats.WQ_FORWARD++;
       pq_it = PQ.erase(pq_it);
-    } else if (do_collision_for_merge(std::begin(PQ), pq_it, *pq_it, read_shamt)) {
+    } else if (do_collision_for_merge(earlier_match(PQ, pq_it), pq_it, *pq_it)) {
       sim_stats.PQ_MERGED++;
       pq_it = PQ.erase(pq_it);
     } else {
@@ -23,6 +23,7 @@
 
 #include "deadlock.h"
 #include "instruction.h"
+#include "util/algorithm.h" // for set_union_into
 #include "util/bits.h" // for lg2, bitmask
 #include "util/span.h"
 #include "util/units.h"
@@ -111,7 +112,7 @@ long DRAM_CHANNEL::operate()
   if (warmup) {
     for (auto& entry : RQ) {
       if (entry.has_value()) {
-        response_type response{entry->address, entry->v_address, entry->data, entry->pf_metadata, entry->instr_depend_on_me};
+        response_type response{entry->address, entry->v_address, entry->data, entry->pf_metadata, std::move(entry->instr_depend_on_me)};
         for (auto* ret : entry.value().to_return) {
           ret->push_back(response);
         }
@@ -146,7 +147,7 @@ long DRAM_CHANNEL::finish_dbus_request()
 
   if (active_request != std::end(bank_request) && active_request->ready_time <= current_time) {
     response_type response{active_request->pkt->value().address, active_request->pkt->value().v_address, active_request->pkt->value().data,
-                           active_request->pkt->value().pf_metadata, active_request->pkt->value().instr_depend_on_me};
+                           active_request->pkt->value().pf_metadata, std::move(active_request->pkt->value().instr_depend_on_me)};
     for (auto* ret : active_request->pkt->value().to_return) {
       ret->push_back(response);
     }
@@ -270,16 +271,18 @@ long DRAM_CHANNEL::populate_dbus()
       // set when bankgroup dbus will be next ready
       bankgroup_readytime[op_bankgroup] = current_time + DRAM_DBUS_RETURN_TIME + DRAM_DBUS_BANKGROUP_STALL;
 
+      // Requests from a set-sampled cache stand for several accesses
+      const auto weight = iter_next_process->pkt->value().sample_weight;
       if (iter_next_process->row_buffer_hit) {
         if (write_mode) {
-          ++sim_stats.WQ_ROW_BUFFER_HIT;
+          sim_stats.WQ_ROW_BUFFER_HIT += weight;
         } else {
-          ++sim_stats.RQ_ROW_BUFFER_HIT;
+          sim_stats.RQ_ROW_BUFFER_HIT += weight;
         }
       } else if (write_mode) {
-        ++sim_stats.WQ_ROW_BUFFER_MISS;
+        sim_stats.WQ_ROW_BUFFER_MISS += weight;
       } else {
-        ++sim_stats.RQ_ROW_BUFFER_MISS;
+        sim_stats.RQ_ROW_BUFFER_MISS += weight;
       }
 
       ++progress;
@@ -453,7 +456,7 @@ void DRAM_CHANNEL::check_read_collision()
       // write forward
       if (auto wq_it = std::find_if(std::begin(WQ), std::end(WQ), checker); wq_it != std::end(WQ)) {
         response_type response{rq_it->value().address, rq_it->value().v_address, wq_it->value().data, rq_it->value().pf_metadata,
-                               rq_it->value().instr_depend_on_me};
+                               std::move(rq_it->value().instr_depend_on_me)};
         for (auto* ret : rq_it->value().to_return) {
           ret->push_back(response);
         }
@@ -463,26 +466,16 @@ void DRAM_CHANNEL::check_read_collision()
       }
       // backwards check
       else if (auto found = std::find_if(std::begin(RQ), rq_it, checker); found != rq_it) {
-        auto instr_copy = std::move(found->value().instr_depend_on_me);
-        auto ret_copy = std::move(found->value().to_return);
-
-        std::set_union(std::begin(instr_copy), std::end(instr_copy), std::begin(rq_it->value().instr_depend_on_me), std::end(rq_it->value().instr_depend_on_me),
-                       std::back_inserter(found->value().instr_depend_on_me));
-        std::set_union(std::begin(ret_copy), std::end(ret_copy), std::begin(rq_it->value().to_return), std::end(rq_it->value().to_return),
-                       std::back_inserter(found->value().to_return));
+        champsim::set_union_into(found->value().instr_depend_on_me, rq_it->value().instr_depend_on_me);
+        champsim::set_union_into(found->value().to_return, rq_it->value().to_return);
 
         rq_it->reset();
 
       }
       // forwards check
       else if (found = std::find_if(std::next(rq_it), std::end(RQ), checker); found != std::end(RQ)) {
-        auto instr_copy = std::move(found->value().instr_depend_on_me);
-        auto ret_copy = std::move(found->value().to_return);
-
-        std::set_union(std::begin(instr_copy), std::end(instr_copy), std::begin(rq_it->value().instr_depend_on_me), std::end(rq_it->value().instr_depend_on_me),
-                       std::back_inserter(found->value().instr_depend_on_me));
-        std::set_union(std::begin(ret_copy), std::end(ret_copy), std::begin(rq_it->value().to_return), std::end(rq_it->value().to_return),
-                       std::back_inserter(found->value().to_return));
+        champsim::set_union_into(found->value().instr_depend_on_me, rq_it->value().instr_depend_on_me);
+        champsim::set_union_into(found->value().to_return, rq_it->value().to_return);
 
         rq_it->reset();
       } else {
@@ -502,7 +495,7 @@ void MEMORY_CONTROLLER::initiate_requests()
     }
 
     // Initiate write requests
-    auto [wq_begin, wq_end] = champsim::get_span_p(std::cbegin(ul->WQ), std::cend(ul->WQ), [this](const auto& pkt) { return this->add_wq(pkt); });
+    auto [wq_begin, wq_end] = champsim::get_span_p(std::cbegin(ul->WQ), std::cend(ul->WQ), [ul, this](const auto& pkt) { return this->add_wq(pkt, ul); });
     ul->WQ.erase(wq_begin, wq_end);
   }
 }
@@ -524,6 +517,7 @@ bool MEMORY_CONTROLLER::add_rq(const request_type& packet, champsim::channel* ul
     rq_it->value().forward_checked = false;
     rq_it->value().scheduled = false;
     rq_it->value().ready_time = current_time;
+    rq_it->value().sample_weight = ul->sample_weight;
     if (packet.response_requested)
       rq_it->value().to_return = {&ul->returned};
 
@@ -533,7 +527,7 @@ bool MEMORY_CONTROLLER::add_rq(const request_type& packet, champsim::channel* ul
   return false;
 }
 
-bool MEMORY_CONTROLLER::add_wq(const request_type& packet)
+bool MEMORY_CONTROLLER::add_wq(const request_type& packet, champsim::channel* ul)
 {
   auto& channel = channels[address_mapping.get_channel(packet.address)];
 
@@ -544,6 +538,7 @@ bool MEMORY_CONTROLLER::add_wq(const request_type& packet)
     wq_it->value().forward_checked = false;
     wq_it->value().scheduled = false;
     wq_it->value().ready_time = current_time;
+    wq_it->value().sample_weight = ul->sample_weight;
 
     return true;
   }
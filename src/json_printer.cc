@@ -49,11 +49,44 @@ void to_json(nlohmann::json& j, const CACHE::stats_type& stats)
   std::map<std::string, nlohmann::json> statsmap;
   statsmap.emplace("prefetch requested", stats.pf_requested);
   statsmap.emplace("prefetch dropped", stats.pf_dropped);
+  statsmap.emplace("prefetch filtered", stats.pf_filtered);
   statsmap.emplace("prefetch issued", stats.pf_issued);
   statsmap.emplace("useful prefetch", stats.pf_useful);
   statsmap.emplace("useless prefetch", stats.pf_useless);
   statsmap.emplace("late prefetch", stats.pf_late);
 
+  if (!std::empty(stats.pf_by_ip)) {
+    std::vector<nlohmann::json> by_ip;
+    for (const auto& x : stats.pf_by_ip) {
+      by_ip.push_back(nlohmann::json{{"ip", x.ip},
+                                     {"prefetch issued", x.issued},
+                                     {"useful prefetch", x.useful},
+                                     {"late prefetch", x.late},
+                                     {"useless prefetch", x.useless},
+                                     {"miss", x.misses},
+                                     {"covered miss", x.covered}});
+    }
+    statsmap.emplace("prefetch by IP", by_ip);
+  }
+
+  if (!std::empty(stats.pf_shadow)) {
+    std::vector<nlohmann::json> shadows;
+    for (const auto& x : stats.pf_shadow) {
+      shadows.push_back(nlohmann::json{{"prefetch issued", x.issued},
+                                       {"redundant prefetch", x.redundant},
+                                       {"useful prefetch", x.useful},
+                                       {"useless prefetch", x.useless},
+                                       {"miss", x.demand_misses},
+                                       {"covered miss", x.covered}});
+    }
+    statsmap.emplace("shadow prefetchers", shadows);
+  }
+
+  if (!std::empty(stats.stack_position_hits)) {
+    statsmap.emplace("LRU hit curve", lru_hit_curve(stats));
+    statsmap.emplace("LRU miss curve", lru_miss_curve(stats));
+  }
+
   uint64_t total_downstream_demands = stats.mshr_return.total();
   for (std::size_t cpu = 0; cpu < NUM_CPUS; ++cpu)
     total_downstream_demands -= stats.mshr_return.value_or(std::pair{access_type::PREFETCH, cpu}, mshr_return_value_type{});
@@ -37,7 +37,7 @@
 
 namespace champsim
 {
-std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases, std::vector<tracereader>& traces);
+std::vector<phase_stats> main(environment& env, std::vector<phase_info>& phases, std::vector<tracereader>& traces, const cache_snapshot_paths& snapshots);
 }
 
 #ifndef CHAMPSIM_TEST_BUILD
@@ -63,7 +63,10 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
   long long warmup_instructions = 0;
   long long simulation_instructions = std::numeric_limits<long long>::max();
   std::string json_file_name;
+  champsim::cache_snapshot_paths snapshots;
   std::vector<std::string> trace_names;
+  std::string prefetcher_profile;
+  std::string replacement_profile;
 
   auto set_heartbeat_callback = [&](auto) {
     for (O3_CPU& cpu : gen_environment.cpu_view()) {
@@ -84,6 +87,17 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
   auto* json_option =
       app.add_option("--json", json_file_name, "The name of the file to receive JSON output. If no name is specified, stdout will be used")->expected(0, 1);
 
+  app.add_option("--load-cache-snapshot", snapshots.load_from, "The directory to load the contents of each cache from before the simulation starts")
+      ->check(CLI::ExistingDirectory);
+  app.add_option("--save-cache-snapshot", snapshots.save_to, "The directory to save the contents of each cache to after the warmup phase")
+      ->check(CLI::ExistingDirectory);
+
+  auto* profile_option = app.add_option("--prefetcher-profile", prefetcher_profile, "The profile for profile-guided prefetchers to load, in every cache")
+                             ->check(CLI::ExistingFile);
+  auto* repl_profile_option =
+      app.add_option("--replacement-profile", replacement_profile, "The profile for trace-driven replacement policies to load, in every cache")
+          ->check(CLI::ExistingFile);
+
   app.add_option("traces", trace_names, "The paths to the traces")->required()->expected(NUM_CPUS)->check(CLI::ExistingFile);
 
   CLI11_PARSE(app, argc, argv);
@@ -105,6 +119,18 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
     warmup_instructions = simulation_instructions / 5;
   }
 
+  if (profile_option->count() > 0) {
+    for (CACHE& cache : gen_environment.cache_view()) {
+      cache.prefetcher_profile = prefetcher_profile;
+    }
+  }
+
+  if (repl_profile_option->count() > 0) {
+    for (CACHE& cache : gen_environment.cache_view()) {
+      cache.replacement_profile = replacement_profile;
+    }
+  }
+
   std::vector<champsim::tracereader> traces;
   std::transform(
       std::begin(trace_names), std::end(trace_names), std::back_inserter(traces),
@@ -121,7 +147,7 @@ int main(int argc, char** argv) // NOLINT(bugprone-exception-escape)
   fmt::print("\n*** ChampSim Multicore Out-of-Order Simulator ***\nWarmup Instructions: {}\nSimulation Instructions: {}\nNumber of CPUs: {}\nPage size: {}\n\n",
              phases.at(0).length, phases.at(1).length, std::size(gen_environment.cpu_view()), PAGE_SIZE);
 
-  auto phase_stats = champsim::main(gen_environment, phases, traces);
+  auto phase_stats = champsim::main(gen_environment, phases, traces, snapshots);
 
   fmt::print("\nChampSim completed all CPUs\n\n");
 
@@ -23,6 +23,11 @@ bool champsim::modules::prefetcher::prefetch_line(champsim::address pf_addr, boo
   return intern_->prefetch_line(pf_addr, fill_this_level, prefetch_metadata);
 }
 
+std::size_t champsim::modules::prefetcher::prefetch_lines(const std::vector<champsim::prefetch_request>& requests) const
+{
+  return intern_->prefetch_lines(requests);
+}
+
 // LCOV_EXCL_START Exclude deprecated function
 bool champsim::modules::prefetcher::prefetch_line(uint64_t pf_addr, bool fill_this_level, uint32_t prefetch_metadata) const
 {
@@ -23,6 +23,7 @@
 #include <fmt/chrono.h>
 #include <fmt/core.h>
 #include <fmt/ostream.h>
+#include <fmt/ranges.h>
 
 #include "stats_printer.h"
 
@@ -116,14 +117,25 @@ std::vector<std::string> champsim::plain_printer::format(CACHE::stats_type stats
                       stats.mshr_merge.value_or(std::pair{type, cpu}, mshr_merge_value_type{})));
     }
 
-    lines.push_back(fmt::format("cpu{}->{} PREFETCH REQUESTED: {:10} ISSUED: {:10} USEFUL: {:10} USELESS: {:10} LATE: {:10} DROP: {:10}", cpu, stats.name, stats.pf_requested,
-                                stats.pf_issued, stats.pf_useful, stats.pf_useless, stats.pf_late, stats.pf_dropped));
+    lines.push_back(fmt::format("cpu{}->{} PREFETCH REQUESTED: {:10} ISSUED: {:10} USEFUL: {:10} USELESS: {:10} LATE: {:10} DROP: {:10} FILTERED: {:10}", cpu, stats.name,
+                                stats.pf_requested, stats.pf_issued, stats.pf_useful, stats.pf_useless, stats.pf_late, stats.pf_dropped, stats.pf_filtered));
 
     uint64_t total_downstream_demands = total_mshr_return - stats.mshr_return.value_or(std::pair{access_type::PREFETCH, cpu}, mshr_return_value_type{});
     lines.push_back(
         fmt::format("cpu{}->{} AVERAGE MISS LATENCY: {} cycles", cpu, stats.name, ::print_ratio(stats.total_miss_latency_cycles, total_downstream_demands)));
   }
 
+  if (!std::empty(stats.stack_position_hits)) {
+    lines.push_back(fmt::format("{} LRU MISSES BY WAYS: {}", stats.name, fmt::join(lru_miss_curve(stats), " ")));
+  }
+
+  for (std::size_t i = 0; i < std::size(stats.pf_shadow); ++i) {
+    const auto& shadow = stats.pf_shadow[i];
+    lines.push_back(fmt::format("{} SHADOW PREFETCHER {} ISSUED: {:10} USEFUL: {:10} USELESS: {:10} REDUNDANT: {:10} ACCURACY: {} COVERAGE: {}", stats.name, i,
+                                shadow.issued, shadow.useful, shadow.useless, shadow.redundant, ::print_ratio(shadow.useful, shadow.issued),
+                                ::print_ratio(shadow.covered, shadow.demand_misses)));
+  }
+
   return lines;
 }
 
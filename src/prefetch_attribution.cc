@@ -0,0 +1,156 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "prefetch_attribution.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+// An id holds the entry's generation in its upper half and its index, plus one, in its lower half
+constexpr unsigned INDEX_BITS = 32;
+constexpr uint64_t INDEX_MASK = (uint64_t{1} << INDEX_BITS) - 1;
+} // namespace
+
+champsim::prefetch_attribution::prefetch_attribution(std::size_t capacity) : entries(capacity), heap(capacity)
+{
+  if (capacity == 0 || capacity >= INDEX_MASK)
+    throw std::range_error{"Prefetch attribution capacity is out of bounds"};
+  index.reserve(capacity);
+
+  // Every entry is unused and empty, so any order is a heap
+  std::iota(std::begin(heap), std::end(heap), std::size_t{0});
+  for (std::size_t i = 0; i < capacity; ++i)
+    entries[i].heap_pos = i;
+}
+
+void champsim::prefetch_attribution::sift_down(std::size_t pos)
+{
+  auto key = [this](std::size_t idx) { return std::pair{entries[idx].used, entries[idx].stats.volume}; };
+  for (auto child = 2 * pos + 1; child < std::size(heap); child = 2 * pos + 1) {
+    if (child + 1 < std::size(heap) && key(heap[child + 1]) < key(heap[child]))
+      ++child;
+    if (!(key(heap[child]) < key(heap[pos])))
+      break;
+
+    std::swap(heap[pos], heap[child]);
+    entries[heap[pos]].heap_pos = pos;
+    entries[heap[child]].heap_pos = child;
+    pos = child;
+  }
+}
+
+void champsim::prefetch_attribution::add_volume(std::size_t idx, uint64_t weight)
+{
+  // Volumes only grow between clears, so an entry can only move away from the top
+  entries[idx].stats.volume += weight;
+  sift_down(entries[idx].heap_pos);
+}
+
+std::size_t champsim::prefetch_attribution::track(uint64_t ip, uint64_t weight)
+{
+  if (auto found = index.find(ip); found != std::end(index)) {
+    add_volume(found->second, weight);
+    return found->second;
+  }
+
+  // Take an unused entry, or displace the one with the least volume
+  auto idx = heap.front();
+  auto& chosen = entries[idx];
+  auto inherited = chosen.used ? chosen.stats.volume : 0;
+  if (chosen.used)
+    index.erase(chosen.stats.ip);
+
+  chosen.stats = ip_prefetch_stats{};
+  chosen.stats.ip = ip;
+  chosen.stats.volume = inherited + weight;
+  chosen.used = true;
+  ++chosen.generation;
+  sift_down(0);
+
+  index.emplace(ip, idx);
+  return idx;
+}
+
+auto champsim::prefetch_attribution::resolve(id_type id, uint64_t weight) -> ip_prefetch_stats*
+{
+  if (id == NONE)
+    return nullptr;
+
+  auto idx = static_cast<std::size_t>((id & INDEX_MASK) - 1);
+  auto& chosen = entries.at(idx);
+  if (!chosen.used || chosen.generation != (id >> INDEX_BITS))
+    return nullptr;
+
+  add_volume(idx, weight);
+  return &chosen.stats;
+}
+
+auto champsim::prefetch_attribution::issue(uint64_t trigger_ip, uint64_t weight) -> id_type
+{
+  auto idx = track(trigger_ip, weight);
+  entries[idx].stats.issued += weight;
+  return (id_type{entries[idx].generation} << INDEX_BITS) | static_cast<id_type>(idx + 1);
+}
+
+void champsim::prefetch_attribution::useful(id_type trigger, uint64_t weight)
+{
+  if (auto stats = resolve(trigger, weight); stats != nullptr)
+    stats->useful += weight;
+}
+
+void champsim::prefetch_attribution::late(id_type trigger, uint64_t weight)
+{
+  if (auto stats = resolve(trigger, weight); stats != nullptr)
+    stats->late += weight;
+}
+
+void champsim::prefetch_attribution::useless(id_type trigger, uint64_t weight)
+{
+  if (auto stats = resolve(trigger, weight); stats != nullptr)
+    stats->useless += weight;
+}
+
+void champsim::prefetch_attribution::miss(uint64_t demand_ip, uint64_t weight) { entries[track(demand_ip, weight)].stats.misses += weight; }
+
+void champsim::prefetch_attribution::covered(uint64_t demand_ip, uint64_t weight) { entries[track(demand_ip, weight)].stats.covered += weight; }
+
+void champsim::prefetch_attribution::clear()
+{
+  for (auto& x : entries) {
+    x.stats = ip_prefetch_stats{};
+    x.used = false;
+    ++x.generation;
+  }
+  index.clear();
+
+  // Every entry is unused and empty again, so the heap is still in order
+}
+
+auto champsim::prefetch_attribution::top() const -> std::vector<ip_prefetch_stats>
+{
+  std::vector<ip_prefetch_stats> result;
+  for (const auto& x : entries) {
+    if (x.used)
+      result.push_back(x.stats);
+  }
+  std::sort(std::begin(result), std::end(result), [](const auto& x, const auto& y) { return x.volume > y.volume; });
+  return result;
+}
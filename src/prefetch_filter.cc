@@ -0,0 +1,52 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "prefetch_filter.h"
+
+#include <algorithm>
+
+champsim::prefetch_filter::prefetch_filter(std::size_t size) : bits(std::max<std::size_t>(size, 1), false) {}
+
+std::pair<std::size_t, std::size_t> champsim::prefetch_filter::indices(uint64_t block) const
+{
+  // splitmix64 finalizer, whose two halves serve as independent hashes
+  block ^= block >> 30;
+  block *= 0xbf58476d1ce4e5b9ull;
+  block ^= block >> 27;
+  block *= 0x94d049bb133111ebull;
+  block ^= block >> 31;
+  return {static_cast<std::size_t>(block & 0xffffffff) % std::size(bits), static_cast<std::size_t>(block >> 32) % std::size(bits)};
+}
+
+void champsim::prefetch_filter::insert(uint64_t block)
+{
+  auto [first, second] = indices(block);
+  bits[first] = true;
+  bits[second] = true;
+}
+
+void champsim::prefetch_filter::erase(uint64_t block)
+{
+  auto [first, second] = indices(block);
+  bits[first] = false;
+  bits[second] = false;
+}
+
+bool champsim::prefetch_filter::maybe_contains(uint64_t block) const
+{
+  auto [first, second] = indices(block);
+  return bits[first] && bits[second];
+}
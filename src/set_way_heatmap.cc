@@ -0,0 +1,53 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "set_way_heatmap.h"
+
+#include <algorithm>
+#include <fstream>
+#include <fmt/core.h>
+#include <fmt/ostream.h>
+
+champsim::set_way_heatmap::set_way_heatmap(std::size_t sets, std::size_t ways)
+    : columns(ways + 1), accesses(sets * columns), fills(sets * columns), evictions(sets * columns)
+{
+}
+
+void champsim::set_way_heatmap::write_interval(const std::string& file_name)
+{
+  std::ofstream file{file_name, interval == 0 ? std::ios::trunc : std::ios::app};
+  if (interval == 0) {
+    fmt::print(file, "interval,set,way,accesses,fills,evictions\n");
+  }
+
+  for (std::size_t i = 0; i < std::size(accesses); ++i) {
+    if (accesses[i] != 0 || fills[i] != 0) {
+      fmt::print(file, "{},{},{},{},{},{}\n", interval, i / columns, i % columns, accesses[i], fills[i], evictions[i]);
+    }
+  }
+
+  std::fill(std::begin(accesses), std::end(accesses), 0);
+  std::fill(std::begin(fills), std::end(fills), 0);
+  std::fill(std::begin(evictions), std::end(evictions), 0);
+  ++interval;
+}
+
+void champsim::set_way_heatmap::end_phase(const std::string& file_name, std::size_t num_cpus)
+{
+  if (++phase_ends == num_cpus) {
+    write_interval(file_name);
+  }
+}
@@ -0,0 +1,47 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shadow_directory.h"
+
+champsim::shadow_directory::shadow_directory(std::size_t sets, std::size_t ways) : blocks(sets, ways) {}
+
+void champsim::shadow_directory::prefetch(uint64_t block, bool resident, uint32_t weight)
+{
+  if (resident || blocks.find(block) != nullptr) {
+    stats.redundant += weight;
+    return;
+  }
+
+  stats.issued += weight;
+  if (auto evicted = blocks.insert(block, weight); evicted.has_value()) {
+    stats.useless += evicted->data;
+  }
+}
+
+void champsim::shadow_directory::access(uint64_t block, bool demand_miss, uint32_t weight)
+{
+  auto found = blocks.erase(block);
+  if (found.has_value()) {
+    stats.useful += found.value();
+  }
+
+  if (demand_miss) {
+    stats.demand_misses += weight;
+    if (found.has_value()) {
+      stats.covered += weight;
+    }
+  }
+}
@@ -0,0 +1,49 @@
+/*
+ *    Copyright 2023 The ChampSim Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack_distance_monitor.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+champsim::stack_distance_monitor::stack_distance_monitor(std::size_t sets, std::size_t ways) : num_ways(ways), stacks(sets * ways), depths(sets) {}
+
+std::size_t champsim::stack_distance_monitor::access(long set, uint64_t block)
+{
+  assert(set >= 0 && static_cast<std::size_t>(set) < std::size(depths));
+  auto& depth = depths[static_cast<std::size_t>(set)];
+  auto set_begin = std::next(std::begin(stacks), set * static_cast<long>(num_ways));
+  auto set_end = std::next(set_begin, static_cast<long>(depth));
+
+  auto found = std::find(set_begin, set_end, block);
+  const auto position = (found == set_end) ? num_ways : static_cast<std::size_t>(std::distance(set_begin, found));
+
+  if (found == set_end) {
+    // Miss: push the block on the stack, and the least recently used block falls off the bottom if the stack is full
+    if (depth < num_ways) {
+      ++depth;
+      ++set_end;
+    }
+    found = std::prev(set_end);
+    *found = block;
+  }
+
+  std::rotate(set_begin, found, std::next(found));
+  return position;
+}
+
+std::size_t champsim::stack_distance_monitor::ways() const { return num_ways; }
@@ -18,6 +18,7 @@
 
 #include <fstream>
 #include <string>
+#include <vector>
 
 #include "inf_stream.h"
 #include "repeatable.h"
@@ -26,6 +27,20 @@ namespace champsim
 {
 uint64_t tracereader::instr_unique_id = 0; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
+namespace
+{
+std::vector<tracereader*> lookahead_traces; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+}
+
+void lookahead::attach(uint32_t cpu, tracereader* trace)
+{
+  if (std::size(lookahead_traces) <= cpu)
+    lookahead_traces.resize(cpu + 1, nullptr);
+  lookahead_traces[cpu] = trace;
+}
+
+tracereader* lookahead::trace(uint32_t cpu) { return cpu < std::size(lookahead_traces) ? lookahead_traces[cpu] : nullptr; }
+
 ooo_model_instr apply_branch_target(ooo_model_instr branch, const ooo_model_instr& target)
 {
   branch.branch_target = (branch.is_branch && branch.branch_taken) ? target.ip : champsim::address{};
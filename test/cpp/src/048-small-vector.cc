@@ -0,0 +1,127 @@
+#include <catch.hpp>
+#include <type_traits>
+#include <vector>
+
+#include "util/algorithm.h"
+#include "util/small_vector.h"
+
+TEST_CASE("A small_vector is copiable and moveable")
+{
+  STATIC_REQUIRE(std::is_copy_constructible_v<champsim::small_vector<int, 2>>);
+  STATIC_REQUIRE(std::is_move_constructible_v<champsim::small_vector<int, 2>>);
+  STATIC_REQUIRE(std::is_copy_assignable_v<champsim::small_vector<int, 2>>);
+  STATIC_REQUIRE(std::is_move_assignable_v<champsim::small_vector<int, 2>>);
+}
+
+SCENARIO("A small_vector keeps short lists inline")
+{
+  GIVEN("A small_vector with inline capacity 2")
+  {
+    champsim::small_vector<int, 2> uut{};
+
+    WHEN("Two elements are added")
+    {
+      uut.push_back(1);
+      uut.push_back(2);
+
+      THEN("The elements are stored inline")
+      {
+        REQUIRE(uut.is_inline());
+        REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{1, 2}));
+      }
+
+      AND_WHEN("The vector is copied")
+      {
+        auto copy = uut;
+
+        THEN("The copy has the same elements and is also inline")
+        {
+          REQUIRE(copy.is_inline());
+          REQUIRE(copy == uut);
+        }
+      }
+    }
+
+    WHEN("More elements are added than fit inline")
+    {
+      uut.push_back(1);
+      uut.push_back(2);
+      uut.push_back(3);
+      uut.push_back(4);
+      uut.push_back(5);
+
+      THEN("The elements spill to the heap and are preserved")
+      {
+        REQUIRE_FALSE(uut.is_inline());
+        REQUIRE(uut.capacity() >= 5);
+        REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{1, 2, 3, 4, 5}));
+      }
+
+      AND_WHEN("The vector is moved")
+      {
+        auto moved = std::move(uut);
+
+        THEN("The storage is transferred")
+        {
+          REQUIRE_FALSE(moved.is_inline());
+          REQUIRE_THAT(moved, Catch::Matchers::RangeEquals(std::vector{1, 2, 3, 4, 5}));
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Elements can be erased from a small_vector")
+{
+  GIVEN("A small_vector with three elements")
+  {
+    champsim::small_vector<int, 4> uut{1, 2, 3};
+
+    WHEN("The first element is erased")
+    {
+      auto it = uut.erase(std::begin(uut));
+
+      THEN("The remaining elements are shifted forward")
+      {
+        REQUIRE(it == std::begin(uut));
+        REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{2, 3}));
+      }
+    }
+
+    WHEN("A range is erased")
+    {
+      uut.erase(std::next(std::begin(uut)), std::end(uut));
+
+      THEN("Only the first element remains") { REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{1})); }
+    }
+  }
+}
+
+SCENARIO("Sorted small_vectors can be merged in place")
+{
+  GIVEN("Two sorted lists of dependents")
+  {
+    champsim::small_vector<uint64_t, 4> dest{1, 3, 5};
+    champsim::small_vector<uint64_t, 4> source{2, 3, 6};
+
+    WHEN("The lists are merged")
+    {
+      champsim::set_union_into(dest, source);
+
+      THEN("The destination holds the sorted union") { REQUIRE_THAT(dest, Catch::Matchers::RangeEquals(std::vector<uint64_t>{1, 2, 3, 5, 6})); }
+    }
+  }
+
+  GIVEN("An empty destination")
+  {
+    champsim::small_vector<uint64_t, 4> dest{};
+    champsim::small_vector<uint64_t, 4> source{2, 4};
+
+    WHEN("The lists are merged")
+    {
+      champsim::set_union_into(dest, source);
+
+      THEN("The destination is a copy of the source") { REQUIRE(dest == source); }
+    }
+  }
+}
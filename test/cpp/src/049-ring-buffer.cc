@@ -0,0 +1,120 @@
+#include <catch.hpp>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "util/ring_buffer.h"
+
+TEST_CASE("A ring_buffer is copiable and moveable")
+{
+  STATIC_REQUIRE(std::is_copy_constructible_v<champsim::ring_buffer<int>>);
+  STATIC_REQUIRE(std::is_move_constructible_v<champsim::ring_buffer<int>>);
+  STATIC_REQUIRE(std::is_copy_assignable_v<champsim::ring_buffer<int>>);
+  STATIC_REQUIRE(std::is_move_assignable_v<champsim::ring_buffer<int>>);
+}
+
+SCENARIO("A ring_buffer behaves as a queue")
+{
+  GIVEN("A ring_buffer with a small capacity")
+  {
+    champsim::ring_buffer<int> uut{4};
+    REQUIRE(uut.capacity() == 4);
+
+    WHEN("Elements are pushed and popped past the capacity")
+    {
+      for (int i = 0; i < 10; ++i) {
+        uut.push_back(i);
+        if (std::size(uut) > 2) {
+          uut.pop_front();
+        }
+      }
+
+      THEN("The buffer wraps around without growing")
+      {
+        REQUIRE(uut.capacity() == 4);
+        REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{8, 9}));
+      }
+    }
+
+    WHEN("More elements are pushed than the capacity")
+    {
+      for (int i = 0; i < 6; ++i) {
+        uut.push_back(i);
+      }
+
+      THEN("The buffer grows and preserves the order")
+      {
+        REQUIRE(uut.capacity() >= 6);
+        REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{0, 1, 2, 3, 4, 5}));
+      }
+    }
+  }
+}
+
+SCENARIO("Elements can be erased from a ring_buffer")
+{
+  GIVEN("A ring_buffer with wrapped elements")
+  {
+    champsim::ring_buffer<int> uut{8};
+    for (int i = 0; i < 12; ++i) {
+      uut.push_back(i);
+      if (std::size(uut) > 6) {
+        uut.pop_front();
+      }
+    }
+    REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{6, 7, 8, 9, 10, 11}));
+
+    WHEN("A range near the front is erased")
+    {
+      auto it = uut.erase(std::next(std::cbegin(uut), 1), std::next(std::cbegin(uut), 3));
+
+      THEN("The remaining elements keep their order")
+      {
+        REQUIRE(*it == 9);
+        REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{6, 9, 10, 11}));
+      }
+    }
+
+    WHEN("A range near the back is erased")
+    {
+      auto it = uut.erase(std::next(std::cbegin(uut), 3), std::next(std::cbegin(uut), 5));
+
+      THEN("The remaining elements keep their order")
+      {
+        REQUIRE(*it == 11);
+        REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{6, 7, 8, 11}));
+      }
+    }
+
+    WHEN("The buffer is stably partitioned")
+    {
+      auto mid = std::stable_partition(std::begin(uut), std::end(uut), [](int x) { return x % 2 == 0; });
+      uut.erase(std::begin(uut), mid);
+
+      THEN("Only the odd elements remain") { REQUIRE_THAT(uut, Catch::Matchers::RangeEquals(std::vector{7, 9, 11})); }
+    }
+  }
+}
+
+SCENARIO("A ring_buffer holds types that are not default constructible")
+{
+  GIVEN("A ring_buffer of unique_ptr")
+  {
+    champsim::ring_buffer<std::unique_ptr<int>> uut{};
+
+    WHEN("Elements are added and the buffer grows")
+    {
+      for (int i = 0; i < 5; ++i) {
+        uut.emplace_back(std::make_unique<int>(i));
+      }
+      uut.erase(std::cbegin(uut));
+
+      THEN("The owned values are preserved")
+      {
+        REQUIRE(std::size(uut) == 4);
+        REQUIRE(*uut.front() == 1);
+        REQUIRE(*uut.back() == 4);
+      }
+    }
+  }
+}
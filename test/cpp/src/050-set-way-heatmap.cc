@@ -0,0 +1,89 @@
+#include <catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "set_way_heatmap.h"
+
+namespace
+{
+std::vector<std::string> read_lines(const std::filesystem::path& path)
+{
+  std::ifstream file{path};
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(file, line);)
+    lines.push_back(line);
+  return lines;
+}
+} // namespace
+
+SCENARIO("A set_way_heatmap writes the nonzero counters of each interval")
+{
+  GIVEN("A heatmap with four sets and two ways")
+  {
+    const auto path = std::filesystem::temp_directory_path() / "050-set-way-heatmap.csv";
+    champsim::set_way_heatmap uut{4, 2};
+
+    WHEN("Hits, misses, and fills are recorded and an interval is written")
+    {
+      uut.access(1, 0);
+      uut.access(1, 0);
+      uut.access(3, 2); // a miss
+      uut.fill(3, 1, true);
+      uut.write_interval(path.string());
+
+      THEN("Only the touched counters are written, with misses in the extra column")
+      {
+        REQUIRE_THAT(read_lines(path), Catch::Matchers::RangeEquals(std::vector<std::string>{"interval,set,way,accesses,fills,evictions", "0,1,0,2,0,0",
+                                                                                            "0,3,1,0,1,1", "0,3,2,1,0,0"}));
+      }
+
+      AND_WHEN("A second interval is written")
+      {
+        uut.access(0, 1);
+        uut.write_interval(path.string());
+
+        THEN("The counters were reset and the new interval is appended")
+        {
+          auto lines = read_lines(path);
+          REQUIRE(std::size(lines) == 5);
+          REQUIRE(lines.back() == "1,0,1,1,0,0");
+        }
+      }
+    }
+
+    std::filesystem::remove(path);
+  }
+}
+
+SCENARIO("A set_way_heatmap writes one interval per phase")
+{
+  GIVEN("A heatmap in a system with two cores")
+  {
+    const auto path = std::filesystem::temp_directory_path() / "050-set-way-heatmap-phase.csv";
+    std::filesystem::remove(path);
+    champsim::set_way_heatmap uut{4, 2};
+    uut.begin_phase();
+    uut.access(1, 0);
+
+    WHEN("The first core finishes the phase")
+    {
+      uut.end_phase(path.string(), 2);
+
+      THEN("Nothing is written") { REQUIRE_FALSE(std::filesystem::exists(path)); }
+
+      AND_WHEN("The second core finishes the phase")
+      {
+        uut.end_phase(path.string(), 2);
+
+        THEN("The interval is written once")
+        {
+          REQUIRE_THAT(read_lines(path), Catch::Matchers::RangeEquals(std::vector<std::string>{"interval,set,way,accesses,fills,evictions", "0,1,0,1,0,0"}));
+        }
+      }
+    }
+
+    std::filesystem::remove(path);
+  }
+}
@@ -0,0 +1,135 @@
+#include <catch.hpp>
+
+#include <map>
+#include <type_traits>
+
+#include "msl/assoc_table.h"
+
+namespace
+{
+struct counted {
+  uint64_t value = 0;
+  uint8_t counter = 0;
+};
+
+struct counter_of {
+  uint8_t operator()(const counted& x) const { return x.counter; }
+};
+} // namespace
+
+TEMPLATE_TEST_CASE("An assoc_table is copiable and moveable", "", champsim::msl::table_policy::lru, champsim::msl::table_policy::srrip<>,
+                   champsim::msl::table_policy::priority_lru<>, champsim::msl::table_policy::min_counter<::counter_of>)
+{
+  using table_type = champsim::msl::assoc_table<::counted, TestType>;
+  STATIC_REQUIRE(std::is_copy_constructible_v<table_type>);
+  STATIC_REQUIRE(std::is_move_constructible_v<table_type>);
+  STATIC_REQUIRE(std::is_copy_assignable_v<table_type>);
+  STATIC_REQUIRE(std::is_move_assignable_v<table_type>);
+}
+
+TEMPLATE_TEST_CASE("An assoc_table finds what it holds and reports what it replaces", "", champsim::msl::table_policy::lru,
+                   champsim::msl::table_policy::srrip<>, champsim::msl::table_policy::priority_lru<>, champsim::msl::table_policy::min_counter<::counter_of>)
+{
+  // An odd number of sets checks that keys are split by remainder and quotient
+  champsim::msl::assoc_table<::counted, TestType> uut{3, 2};
+
+  REQUIRE(uut.find(7) == nullptr);
+  REQUIRE_FALSE(uut.insert(7, {70}).has_value());
+  REQUIRE_FALSE(uut.insert(10, {100}).has_value());
+  REQUIRE(uut.find(7) != nullptr);
+  CHECK(uut.find(7)->value == 70);
+
+  auto replaced = uut.insert(7, {71});
+  REQUIRE(replaced.has_value());
+  CHECK(replaced->key == 7);
+  CHECK(replaced->data.value == 70);
+
+  auto evicted = uut.insert(13, {130});
+  REQUIRE(evicted.has_value());
+  CHECK((evicted->key == 7 || evicted->key == 10));
+  CHECK(uut.find(evicted->key) == nullptr);
+  CHECK(uut.find(13) != nullptr);
+
+  std::map<uint64_t, uint64_t> seen;
+  uut.for_each([&seen](uint64_t key, const ::counted& x) { seen[key] = x.value; });
+  CHECK(std::size(seen) == 2);
+  CHECK(seen.at(13) == 130);
+
+  REQUIRE(uut.erase(13).has_value());
+  CHECK(uut.find(13) == nullptr);
+  CHECK_FALSE(uut.erase(13).has_value());
+
+  uut.invalidate_all();
+  CHECK(uut.find(7) == nullptr);
+  CHECK(uut.find(10) == nullptr);
+}
+
+TEST_CASE("An LRU assoc_table evicts the least recently used way")
+{
+  champsim::msl::assoc_table<::counted> uut{1, 3};
+  uut.insert(1, {});
+  uut.insert(2, {});
+  uut.insert(3, {});
+  REQUIRE(uut.touch(1));
+  REQUIRE_FALSE(uut.touch(4));
+
+  auto evicted = uut.insert(4, {});
+  REQUIRE(evicted.has_value());
+  CHECK(evicted->key == 2);
+}
+
+TEST_CASE("An SRRIP assoc_table prefers to evict ways that were not hit")
+{
+  champsim::msl::assoc_table<::counted, champsim::msl::table_policy::srrip<>> uut{1, 3};
+  uut.insert(1, {});
+  uut.insert(2, {});
+  uut.insert(3, {});
+  uut.touch(1);
+  uut.touch(3);
+
+  auto evicted = uut.insert(4, {});
+  REQUIRE(evicted.has_value());
+  CHECK(evicted->key == 2);
+}
+
+TEST_CASE("A priority assoc_table evicts the lowest priority, then by recency")
+{
+  GIVEN("A table that breaks ties towards the least recent way") {
+    champsim::msl::assoc_table<::counted, champsim::msl::table_policy::priority_lru<>> uut{1, 3};
+    uut.insert(1, {}, uint8_t{2});
+    uut.insert(2, {}, uint8_t{1});
+    uut.insert(3, {}, uint8_t{1});
+
+    THEN("The older of the low-priority ways is evicted") {
+      auto evicted = uut.insert(4, {}, uint8_t{2});
+      REQUIRE(evicted.has_value());
+      CHECK(evicted->key == 2);
+    }
+  }
+
+  GIVEN("A table that breaks ties towards the most recent way") {
+    champsim::msl::assoc_table<::counted, champsim::msl::table_policy::priority_lru<true>> uut{1, 3};
+    uut.insert(1, {}, uint8_t{2});
+    uut.insert(2, {}, uint8_t{1});
+    uut.insert(3, {}, uint8_t{1});
+
+    THEN("The newer of the low-priority ways is evicted") {
+      auto evicted = uut.insert(4, {}, uint8_t{2});
+      REQUIRE(evicted.has_value());
+      CHECK(evicted->key == 3);
+    }
+  }
+}
+
+TEST_CASE("A counter assoc_table evicts the way with the smallest counter in its entry")
+{
+  champsim::msl::assoc_table<::counted, champsim::msl::table_policy::min_counter<::counter_of>> uut{1, 3};
+  uut.insert(1, {10, 3});
+  uut.insert(2, {20, 1});
+  uut.insert(3, {30, 2});
+  uut.find(2)->counter = 3;
+
+  auto evicted = uut.insert(4, {40, 0});
+  REQUIRE(evicted.has_value());
+  CHECK(evicted->key == 3);
+}
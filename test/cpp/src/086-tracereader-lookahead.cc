@@ -0,0 +1,82 @@
+#include <catch.hpp>
+
+#include "tracereader.h"
+
+namespace
+{
+// A trace of the given length, whose instructions are numbered by their IPs
+struct numbered_trace {
+  uint64_t length;
+  uint64_t count = 0;
+
+  ooo_model_instr operator()()
+  {
+    input_instr instr{};
+    instr.ip = ++count;
+    return ooo_model_instr{0, instr};
+  }
+
+  [[nodiscard]] bool eof() const { return count >= length; }
+};
+} // namespace
+
+SCENARIO("A tracereader can look ahead of the instructions it has read")
+{
+  GIVEN("A tracereader of five instructions with a lookahead of three")
+  {
+    champsim::tracereader uut{numbered_trace{5}};
+    uut.reserve_lookahead(3);
+
+    THEN("The instructions within the lookahead can be peeked at")
+    {
+      REQUIRE(uut.peek(2) != nullptr);
+      CHECK(uut.peek(2)->ip == champsim::address{3});
+      REQUIRE(uut.peek(0) != nullptr);
+      CHECK(uut.peek(0)->ip == champsim::address{1});
+      CHECK(uut.peek(3) == nullptr);
+    }
+
+    WHEN("Instructions are read after being peeked at")
+    {
+      auto peeked_id = uut.peek(1)->instr_id;
+      auto first = uut();
+      auto second = uut();
+
+      THEN("They are the peeked instructions, with the peeked IDs")
+      {
+        CHECK(first.ip == champsim::address{1});
+        CHECK(second.ip == champsim::address{2});
+        CHECK(second.instr_id == peeked_id);
+      }
+
+      THEN("The lookahead moves with the reads")
+      {
+        REQUIRE(uut.peek(2) != nullptr);
+        CHECK(uut.peek(2)->ip == champsim::address{5});
+      }
+    }
+
+    WHEN("The end of the trace is peeked at")
+    {
+      for (auto i = 0; i < 2; ++i)
+        uut();
+      REQUIRE(uut.peek(2) != nullptr);
+
+      THEN("The trace does not end until the peeked instructions are read")
+      {
+        CHECK_FALSE(uut.eof());
+        CHECK(uut.peek(3) == nullptr);
+        for (auto i = 0; i < 3; ++i)
+          uut();
+        CHECK(uut.eof());
+      }
+    }
+  }
+
+  GIVEN("A tracereader without a lookahead")
+  {
+    champsim::tracereader uut{numbered_trace{5}};
+
+    THEN("Nothing can be peeked at") { CHECK(uut.peek(0) == nullptr); }
+  }
+}
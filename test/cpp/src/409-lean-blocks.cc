@@ -0,0 +1,70 @@
+#include <catch.hpp>
+
+#include "cache.h"
+#include "defaults.hpp"
+#include "mocks.hpp"
+
+SCENARIO("A cache with lean blocks does not keep the data of its blocks")
+{
+  using namespace std::literals;
+  auto [lean, str] = GENERATE(table<bool, std::string_view>({std::pair{true, "lean"sv}, std::pair{false, "full"sv}}));
+
+  GIVEN("An empty cache with " + std::string{str} + " blocks")
+  {
+    champsim::address returned_data{};
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul{[&](auto req, auto resp) {
+      if (req.address != resp.address)
+        return false;
+      returned_data = resp.data;
+      return true;
+    }};
+    auto builder = champsim::cache_builder{champsim::defaults::default_l1d}
+                       .name("409-uut-" + std::string{str})
+                       .upper_levels({&mock_ul.queues})
+                       .lower_level(&mock_ll.queues);
+    CACHE uut{lean ? builder.set_lean_blocks() : builder.reset_lean_blocks()};
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("A load misses and is filled")
+    {
+      decltype(mock_ul)::request_type seed;
+      seed.address = champsim::address{0xdeadbeef};
+      seed.is_translated = true;
+      seed.instr_id = 1;
+      seed.cpu = 0;
+      seed.type = access_type::LOAD;
+      REQUIRE(mock_ul.issue(seed));
+
+      for (auto i = 0; i < 100; ++i)
+        for (auto elem : elements)
+          elem->_operate();
+
+      THEN("The miss returns the data from the lower level") { REQUIRE(returned_data == champsim::address{0x11111111}); }
+
+      AND_WHEN("A load to the same block hits")
+      {
+        returned_data = champsim::address{};
+        auto test = seed;
+        test.instr_id = 2;
+        REQUIRE(mock_ul.issue(test));
+
+        for (auto i = 0; i < 100; ++i)
+          for (auto elem : elements)
+            elem->_operate();
+
+        THEN("The hit returns the data of the block only if the blocks are full")
+        {
+          REQUIRE(uut.sim_stats.hits.value_or(std::pair{access_type::LOAD, uint32_t{0}}, 0) == 1);
+          REQUIRE(returned_data == (lean ? champsim::address{} : champsim::address{0x11111111}));
+        }
+      }
+    }
+  }
+}
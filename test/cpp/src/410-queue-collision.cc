@@ -321,3 +321,153 @@ SCENARIO("Translating cache queues forward RQ virtual to physical RQ")
     }
   }
 }
+
+SCENARIO("Cache queues do not merge with packets that have been consumed")
+{
+  GIVEN("A read queue and write queue that have each held a packet")
+  {
+    champsim::address address{0xdeadbeef};
+    champsim::channel uut{32, 32, 32, champsim::data::bits{LOG2_BLOCK_SIZE}, false};
+
+    issue(uut, address, issue_wq<champsim::channel>);
+    issue(uut, address, issue_rq<champsim::channel>);
+    uut.check_collision();
+    REQUIRE(uut.sim_stats.WQ_FORWARD == 1);
+
+    uut.WQ.erase(std::cbegin(uut.WQ), std::cend(uut.WQ));
+    REQUIRE(uut.WQ.block_count(address) == 0);
+
+    WHEN("A packet with the same address is sent to the read queue")
+    {
+      issue(uut, address, issue_rq<champsim::channel>);
+      uut.check_collision();
+
+      THEN("The packet is neither forwarded nor merged")
+      {
+        REQUIRE(uut.rq_occupancy() == 1);
+        CHECK(uut.sim_stats.WQ_FORWARD == 1);
+        CHECK(uut.sim_stats.RQ_MERGED == 0);
+      }
+
+      AND_WHEN("Another packet with an address in the same block is sent to the read queue")
+      {
+        issue(uut, address + 8, issue_rq<champsim::channel>);
+        REQUIRE(uut.RQ.block_count(address) == 2);
+        uut.check_collision();
+
+        THEN("The packets are merged")
+        {
+          REQUIRE(uut.rq_occupancy() == 1);
+          CHECK(uut.sim_stats.RQ_MERGED == 1);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Cache queues merge several packets in the same block into the oldest")
+{
+  GIVEN("A read queue with one packet")
+  {
+    champsim::address address{0xdeadbeef};
+    champsim::channel uut{32, 32, 32, champsim::data::bits{LOG2_BLOCK_SIZE}, false};
+
+    champsim::channel::request_type seed;
+    seed.address = address;
+    seed.instr_depend_on_me = {1};
+    seed.response_requested = false;
+    uut.add_rq(seed);
+    uut.check_collision();
+
+    WHEN("Three more packets in the same block are sent to the read queue")
+    {
+      for (uint64_t i = 2; i <= 4; ++i) {
+        auto test = seed;
+        test.address = address + static_cast<int>(4 * i);
+        test.instr_depend_on_me = {i};
+        test.response_requested = (i == 3);
+        uut.add_rq(test);
+      }
+      REQUIRE(uut.RQ.block_count(address) == 4);
+
+      uut.check_collision();
+
+      THEN("They are all merged into the first packet")
+      {
+        REQUIRE(uut.rq_occupancy() == 1);
+        CHECK(uut.sim_stats.RQ_MERGED == 3);
+        CHECK(uut.RQ.front().address == address);
+        CHECK(uut.RQ.front().response_requested);
+        CHECK_THAT(uut.RQ.front().instr_depend_on_me, Catch::Matchers::RangeEquals(std::vector<uint64_t>{1, 2, 3, 4}));
+        CHECK(uut.RQ.block_count(address) == 1);
+      }
+    }
+  }
+}
+
+SCENARIO("Cache queues forward from the oldest write in the block")
+{
+  GIVEN("A write queue with two packets in the same block that cannot merge")
+  {
+    champsim::address address{0xdeadbec0};
+    champsim::channel uut{32, 32, 32, champsim::data::bits{LOG2_BLOCK_SIZE}, false};
+
+    champsim::channel::request_type first_write;
+    first_write.address = address;
+    first_write.data = champsim::address{0x1111};
+    first_write.is_translated = false;
+    uut.add_wq(first_write);
+
+    auto second_write = first_write;
+    second_write.address = address + 8;
+    second_write.data = champsim::address{0x2222};
+    second_write.is_translated = true;
+    uut.add_wq(second_write);
+
+    uut.check_collision();
+    REQUIRE(uut.wq_occupancy() == 2);
+    REQUIRE(uut.WQ.block_count(address) == 2);
+
+    WHEN("Several reads in the block are sent to the read queue")
+    {
+      for (int i = 0; i < 3; ++i) {
+        champsim::channel::request_type read;
+        read.address = address + 16 + i;
+        read.is_translated = false;
+        read.instr_depend_on_me = {static_cast<uint64_t>(i)};
+        uut.add_rq(read);
+      }
+      uut.check_collision();
+
+      THEN("Each is answered with the data of the oldest write")
+      {
+        CHECK(uut.rq_occupancy() == 0);
+        CHECK(uut.sim_stats.WQ_FORWARD == 3);
+        REQUIRE(std::size(uut.returned) == 3);
+        CHECK(std::all_of(std::cbegin(uut.returned), std::cend(uut.returned), [](const auto& resp) { return resp.data == champsim::address{0x1111}; }));
+      }
+    }
+
+    WHEN("The oldest write leaves the queue")
+    {
+      uut.WQ.pop_front();
+      REQUIRE(uut.WQ.block_count(address) == 1);
+
+      AND_WHEN("A translated read in the block is sent to the read queue")
+      {
+        champsim::channel::request_type read;
+        read.address = address;
+        read.is_translated = true;
+        uut.add_rq(read);
+        uut.check_collision();
+
+        THEN("It is answered with the data of the remaining write")
+        {
+          CHECK(uut.sim_stats.WQ_FORWARD == 1);
+          REQUIRE(std::size(uut.returned) == 1);
+          CHECK(uut.returned.front().data == champsim::address{0x2222});
+        }
+      }
+    }
+  }
+}
@@ -129,3 +129,67 @@ TEST_CASE("Backed up translation misses do not prevent translated packets from a
   REQUIRE_THAT(mock_ul.packets, Catch::Matchers::SizeIs(1));
   REQUIRE(mock_ul.packets.back().return_time > 0);
 }
+
+TEST_CASE("Translation requests turned away by a full translation queue are retried in order")
+{
+  constexpr uint64_t hit_latency = 4;
+  constexpr uint64_t fill_latency = 1;
+  champsim::channel translator{1, 1, 1, champsim::data::bits{}, false};
+  do_nothing_MRC mock_ll;
+  to_rq_MRP mock_ul{[](auto x, auto y) {
+    return x.v_address == y.v_address;
+  }};
+  CACHE uut{champsim::cache_builder{champsim::defaults::default_l2c}
+                .name("414c-uut")
+                .upper_levels({&mock_ul.queues})
+                .lower_level(&mock_ll.queues)
+                .lower_translate(&translator)
+                .hit_latency(hit_latency)
+                .fill_latency(fill_latency)};
+
+  std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+
+  for (auto elem : elements) {
+    elem->initialize();
+    elem->warmup = false;
+    elem->begin_phase();
+  }
+
+  std::array<champsim::page_number, 4> addresses;
+  std::iota(std::begin(addresses), std::end(addresses), champsim::page_number{0xdeadb});
+
+  for (auto addr : addresses) {
+    decltype(mock_ul)::request_type test;
+    test.address = champsim::address{addr};
+    test.v_address = test.address;
+    test.is_translated = false;
+    test.cpu = 0;
+    mock_ul.issue(test);
+  }
+
+  // The translation queue holds one request, and one translation is answered each cycle, so all but one of the tag checks initiated
+  // together are turned away at first, and their tag checks fall due before they can all be translated.
+  std::vector<champsim::address> translation_order;
+  for (int i = 0; i < 100; ++i) {
+    for (auto elem : elements)
+      elem->_operate();
+
+    if (!std::empty(translator.RQ)) {
+      auto pkt = translator.RQ.front();
+      translator.RQ.pop_front();
+      translation_order.push_back(pkt.v_address);
+
+      champsim::channel::response_type response{pkt};
+      response.data = pkt.v_address;
+      translator.returned.push_back(response);
+    }
+  }
+
+  std::vector<champsim::address> expected_order;
+  std::transform(std::begin(addresses), std::end(addresses), std::back_inserter(expected_order), [](auto addr) { return champsim::address{addr}; });
+
+  REQUIRE_THAT(translation_order, Catch::Matchers::RangeEquals(expected_order));
+  REQUIRE_THAT(mock_ll.addresses, Catch::Matchers::RangeEquals(expected_order));
+  REQUIRE_THAT(mock_ul.packets, Catch::Matchers::AllMatch(Catch::Matchers::Predicate<decltype(mock_ul)::result_data>(
+                                    [](const auto& x) { return x.return_time > 0; }, "has returned")));
+}
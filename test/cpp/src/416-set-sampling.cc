@@ -0,0 +1,110 @@
+#include <catch.hpp>
+
+#include "cache.h"
+#include "defaults.hpp"
+#include "mocks.hpp"
+
+SCENARIO("A set-sampled cache only models the sampled sets")
+{
+  GIVEN("A cache that samples one in every four sets")
+  {
+    constexpr auto hit_latency = 2;
+    constexpr auto miss_latency = 3;
+    constexpr auto fill_latency = 2;
+    constexpr auto sample_stride = 4;
+    do_nothing_MRC mock_ll{miss_latency};
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+                  .name("416-uut")
+                  .sets(64)
+                  .sampled_sets(64 / sample_stride)
+                  .upper_levels({&mock_ul.queues})
+                  .lower_level(&mock_ll.queues)
+                  .hit_latency(hit_latency)
+                  .fill_latency(fill_latency)};
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    THEN("The sample stride is derived from the number of sampled sets") { REQUIRE(uut.SET_SAMPLE_STRIDE == sample_stride); }
+
+    WHEN("A load is issued to a set that is not sampled")
+    {
+      decltype(mock_ul)::request_type test;
+      test.address = champsim::address{0x1040}; // set 1
+      test.cpu = 0;
+      test.instr_id = 1;
+      test.type = access_type::LOAD;
+
+      auto test_result = mock_ul.issue(test);
+      THEN("This issue is received") { REQUIRE(test_result); }
+
+      for (uint64_t i = 0; i < 2 * (hit_latency + miss_latency + fill_latency); ++i)
+        for (auto elem : elements)
+          elem->_operate();
+
+      THEN("The packet returns after the hit latency") { REQUIRE_THAT(mock_ul.packets.front(), champsim::test::ReturnedMatcher(hit_latency + 1, 1)); }
+
+      THEN("The packet is not forwarded to the lower level") { REQUIRE(mock_ll.packet_count() == 0); }
+
+      THEN("No statistics are recorded")
+      {
+        REQUIRE(uut.sim_stats.hits.total() == 0);
+        REQUIRE(uut.sim_stats.misses.total() == 0);
+      }
+    }
+
+    WHEN("A load is issued to a sampled set")
+    {
+      decltype(mock_ul)::request_type test;
+      test.address = champsim::address{0x1100}; // set 4
+      test.cpu = 0;
+      test.instr_id = 1;
+      test.type = access_type::LOAD;
+
+      auto test_result = mock_ul.issue(test);
+      THEN("This issue is received") { REQUIRE(test_result); }
+
+      for (uint64_t i = 0; i < 2 * (hit_latency + miss_latency + fill_latency); ++i)
+        for (auto elem : elements)
+          elem->_operate();
+
+      THEN("The packet is forwarded to the lower level") { REQUIRE(mock_ll.packet_count() == 1); }
+
+      THEN("The miss is weighted by the sample stride")
+      {
+        REQUIRE(uut.sim_stats.misses.value_or(std::pair{test.type, test.cpu}, 0) == sample_stride);
+        REQUIRE(uut.sim_stats.total_miss_latency_cycles == sample_stride * (miss_latency + fill_latency));
+      }
+    }
+
+    WHEN("Prefetches are issued to a sampled and an unsampled set")
+    {
+      auto sampled_result = uut.prefetch_line(champsim::address{0x1100}, true, 0);
+      auto unsampled_result = uut.prefetch_line(champsim::address{0x1040}, true, 0);
+
+      THEN("Both prefetches are accepted")
+      {
+        REQUIRE(sampled_result);
+        REQUIRE(unsampled_result);
+      }
+
+      THEN("Only the sampled prefetch is counted, weighted by the sample stride")
+      {
+        REQUIRE(uut.sim_stats.pf_requested == sample_stride);
+        REQUIRE(uut.sim_stats.pf_issued == sample_stride);
+      }
+
+      for (uint64_t i = 0; i < 2 * (hit_latency + miss_latency + fill_latency); ++i)
+        for (auto elem : elements)
+          elem->_operate();
+
+      THEN("Only the sampled prefetch is forwarded to the lower level") { REQUIRE(mock_ll.packet_count() == 1); }
+    }
+  }
+}
@@ -0,0 +1,106 @@
+#include <catch.hpp>
+
+#include "cache.h"
+#include "defaults.hpp"
+#include "mocks.hpp"
+#include "stack_distance_monitor.h"
+
+SCENARIO("The stack distance monitor reports LRU stack positions")
+{
+  GIVEN("A monitor with one set and four ways")
+  {
+    champsim::stack_distance_monitor uut{1, 4};
+
+    WHEN("Four distinct blocks are accessed")
+    {
+      std::vector<std::size_t> positions;
+      for (uint64_t block : {0xa, 0xb, 0xc, 0xd})
+        positions.push_back(uut.access(0, block));
+
+      THEN("Every access misses") { REQUIRE_THAT(positions, Catch::Matchers::RangeEquals(std::vector<std::size_t>(4, uut.ways()))); }
+
+      AND_WHEN("The blocks are accessed again in the same order")
+      {
+        positions.clear();
+        for (uint64_t block : {0xa, 0xb, 0xc, 0xd})
+          positions.push_back(uut.access(0, block));
+
+        THEN("Each block is found at the bottom of the stack") { REQUIRE_THAT(positions, Catch::Matchers::RangeEquals(std::vector<std::size_t>(4, 3))); }
+      }
+
+      AND_WHEN("The most recent block is accessed again")
+      {
+        THEN("It is found at the top of the stack") { REQUIRE(uut.access(0, 0xd) == 0); }
+      }
+
+      AND_WHEN("A fifth block is accessed")
+      {
+        uut.access(0, 0xe);
+
+        THEN("The least recently used block falls off the stack") { REQUIRE(uut.access(0, 0xa) == uut.ways()); }
+      }
+    }
+  }
+}
+
+SCENARIO("A cache with a stack distance monitor produces miss curves")
+{
+  GIVEN("A cache with the stack distance monitor enabled")
+  {
+    constexpr auto hit_latency = 2;
+    constexpr auto fill_latency = 2;
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+                  .name("417-uut")
+                  .sets(1)
+                  .ways(4)
+                  .upper_levels({&mock_ul.queues})
+                  .lower_level(&mock_ll.queues)
+                  .hit_latency(hit_latency)
+                  .fill_latency(fill_latency)
+                  .set_stack_distance_monitor()};
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("Two blocks are each accessed twice")
+    {
+      uint64_t id = 1;
+      for (uint64_t addr : {0x1000, 0x2000, 0x2000, 0x1000}) {
+        decltype(mock_ul)::request_type test;
+        test.address = champsim::address{addr};
+        test.cpu = 0;
+        test.instr_id = id++;
+        test.type = access_type::LOAD;
+        mock_ul.issue(test);
+
+        for (int i = 0; i < 100; ++i)
+          for (auto elem : elements)
+            elem->_operate();
+      }
+
+      THEN("The stack positions are recorded")
+      {
+        REQUIRE_THAT(uut.sim_stats.stack_position_hits, Catch::Matchers::RangeEquals(std::vector<long>{1, 1, 0, 0}));
+        REQUIRE(uut.sim_stats.stack_misses == 2);
+      }
+
+      THEN("The miss curve covers every associativity")
+      {
+        REQUIRE_THAT(lru_miss_curve(uut.sim_stats), Catch::Matchers::RangeEquals(std::vector<long>{3, 2, 2, 2}));
+      }
+
+      THEN("The miss curve is carried into the region of interest")
+      {
+        uut.end_phase(0);
+        REQUIRE_THAT(lru_miss_curve(uut.roi_stats), Catch::Matchers::RangeEquals(std::vector<long>{3, 2, 2, 2}));
+      }
+    }
+  }
+}
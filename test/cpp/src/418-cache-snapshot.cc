@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <sstream>
+
+#include "cache.h"
+#include "defaults.hpp"
+#include "mocks.hpp"
+
+namespace
+{
+void issue_and_run(to_rq_MRP& mock_ul, std::array<champsim::operable*, 3>& elements, uint64_t addr, uint32_t cpu = 0)
+{
+  static uint64_t id = 1;
+  to_rq_MRP::request_type test;
+  test.address = champsim::address{addr};
+  test.cpu = cpu;
+  test.instr_id = id++;
+  test.type = access_type::LOAD;
+  mock_ul.issue(test);
+
+  for (int i = 0; i < 100; ++i)
+    for (auto elem : elements)
+      elem->_operate();
+}
+} // namespace
+
+SCENARIO("A cache can be restored from a snapshot")
+{
+  GIVEN("A snapshot of a cache with one block")
+  {
+    std::stringstream snapshot;
+    {
+      do_nothing_MRC mock_ll;
+      to_rq_MRP mock_ul;
+      CACHE seed{champsim::cache_builder{champsim::defaults::default_l1d}
+                     .name("418-uut")
+                     .sets(64)
+                     .upper_levels({&mock_ul.queues})
+                     .lower_level(&mock_ll.queues)};
+      std::array<champsim::operable*, 3> elements{{&seed, &mock_ll, &mock_ul}};
+      for (auto elem : elements) {
+        elem->initialize();
+        elem->warmup = false;
+        elem->begin_phase();
+      }
+
+      issue_and_run(mock_ul, elements, 0xdeadbeef, 1);
+      seed.save_snapshot(snapshot);
+    }
+
+    WHEN("The snapshot is loaded into a cache with the same geometry")
+    {
+      do_nothing_MRC mock_ll;
+      to_rq_MRP mock_ul;
+      CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+                    .name("418-uut")
+                    .sets(64)
+                    .upper_levels({&mock_ul.queues})
+                    .lower_level(&mock_ll.queues)};
+      std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+      for (auto elem : elements) {
+        elem->initialize();
+        elem->warmup = false;
+        elem->begin_phase();
+      }
+
+      uut.load_snapshot(snapshot);
+
+      THEN("The block keeps the core that filled it")
+      {
+        auto found = std::find_if(std::cbegin(uut.block), std::cend(uut.block), [](const auto& x) { return x.valid; });
+        REQUIRE(found != std::cend(uut.block));
+        REQUIRE(uut.block_cpu.at(static_cast<std::size_t>(std::distance(std::cbegin(uut.block), found))) == 1);
+      }
+
+      issue_and_run(mock_ul, elements, 0xdeadbeef, 1);
+
+      THEN("The block hits without going to the lower level")
+      {
+        REQUIRE(uut.sim_stats.hits.value_or(std::pair{access_type::LOAD, 1u}, 0) == 1);
+        REQUIRE(mock_ll.packet_count() == 0);
+      }
+    }
+
+    WHEN("The snapshot is loaded into a cache with a different number of sets")
+    {
+      CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}.name("418-uut").sets(8)};
+
+      THEN("The load is rejected") { REQUIRE_THROWS_AS(uut.load_snapshot(snapshot), std::invalid_argument); }
+    }
+
+    WHEN("The snapshot is loaded into a cache with a different number of ways")
+    {
+      CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}.name("418-uut").sets(64).ways(4)};
+
+      THEN("The load is rejected") { REQUIRE_THROWS_AS(uut.load_snapshot(snapshot), std::invalid_argument); }
+    }
+
+    WHEN("The snapshot is loaded into a cache with a different name")
+    {
+      CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}.name("418-other")};
+
+      THEN("The load is rejected") { REQUIRE_THROWS_AS(uut.load_snapshot(snapshot), std::invalid_argument); }
+    }
+  }
+
+  GIVEN("A stream that is not a snapshot")
+  {
+    std::stringstream snapshot{"not a snapshot"};
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}.name("418-uut")};
+
+    THEN("The load is rejected") { REQUIRE_THROWS_AS(uut.load_snapshot(snapshot), std::runtime_error); }
+  }
+}
+
+SCENARIO("A snapshot keeps the recency order of each set")
+{
+  GIVEN("A snapshot of a two-way set in which the first block filled was used last")
+  {
+    std::stringstream snapshot;
+    {
+      do_nothing_MRC mock_ll;
+      to_rq_MRP mock_ul;
+      CACHE seed{champsim::cache_builder{champsim::defaults::default_l1d}
+                     .name("418-lru")
+                     .sets(1)
+                     .ways(2)
+                     .upper_levels({&mock_ul.queues})
+                     .lower_level(&mock_ll.queues)};
+      std::array<champsim::operable*, 3> elements{{&seed, &mock_ll, &mock_ul}};
+      for (auto elem : elements) {
+        elem->initialize();
+        elem->warmup = false;
+        elem->begin_phase();
+      }
+
+      issue_and_run(mock_ul, elements, 0x1000);
+      issue_and_run(mock_ul, elements, 0x2000);
+      issue_and_run(mock_ul, elements, 0x1000);
+      seed.save_snapshot(snapshot);
+    }
+
+    WHEN("The snapshot is loaded and a third block is filled")
+    {
+      do_nothing_MRC mock_ll;
+      to_rq_MRP mock_ul;
+      CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+                    .name("418-lru")
+                    .sets(1)
+                    .ways(2)
+                    .upper_levels({&mock_ul.queues})
+                    .lower_level(&mock_ll.queues)};
+      std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+      for (auto elem : elements) {
+        elem->initialize();
+        elem->warmup = false;
+        elem->begin_phase();
+      }
+
+      uut.load_snapshot(snapshot);
+      issue_and_run(mock_ul, elements, 0x3000);
+
+      THEN("The least recently used block is evicted")
+      {
+        REQUIRE(mock_ll.packet_count() == 1);
+        REQUIRE(std::any_of(std::cbegin(uut.block), std::cend(uut.block), [](const auto& x) { return x.valid && x.address == champsim::address{0x1000}; }));
+        REQUIRE(std::none_of(std::cbegin(uut.block), std::cend(uut.block), [](const auto& x) { return x.valid && x.address == champsim::address{0x2000}; }));
+      }
+    }
+  }
+}
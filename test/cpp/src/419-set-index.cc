@@ -0,0 +1,57 @@
+#include <catch.hpp>
+
+#include <algorithm>
+
+#include "cache.h"
+#include "defaults.hpp"
+#include "mocks.hpp"
+
+SCENARIO("A cache places blocks in the set selected by the bits above the offset")
+{
+  auto offset_bits = GENERATE(as<unsigned>{}, 3, 5, 6, 7, 12);
+  auto sets = GENERATE(as<uint32_t>{}, 1, 2, 64, 2048);
+
+  GIVEN("A direct-mapped cache with " + std::to_string(sets) + " sets and " + std::to_string(offset_bits) + " offset bits")
+  {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+                  .name("419-uut")
+                  .sets(sets)
+                  .ways(1)
+                  .offset_bits(champsim::data::bits{offset_bits})
+                  .upper_levels({&mock_ul.queues})
+                  .lower_level(&mock_ll.queues)};
+
+    std::array<champsim::operable*, 3> elements{{&uut, &mock_ll, &mock_ul}};
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    auto address = GENERATE(as<uint64_t>{}, 0xdeadbeef, 0xffffffffffffffc0, 0x123456789abcdef0);
+
+    WHEN("A load to " + std::to_string(address) + " is filled")
+    {
+      to_rq_MRP::request_type test;
+      test.address = champsim::address{address};
+      test.cpu = 0;
+      test.instr_id = 1;
+      test.type = access_type::LOAD;
+      REQUIRE(mock_ul.issue(test));
+
+      for (int i = 0; i < 100; ++i)
+        for (auto elem : elements)
+          elem->_operate();
+
+      THEN("The block is in the set given by slicing the address above the offset")
+      {
+        auto expected = champsim::address{address}.slice(champsim::dynamic_extent{champsim::data::bits{offset_bits}, champsim::lg2(sets)}).to<long>();
+        auto found = std::find_if(std::cbegin(uut.block), std::cend(uut.block), [](const auto& x) { return x.valid; });
+        REQUIRE(found != std::cend(uut.block));
+        REQUIRE(std::distance(std::cbegin(uut.block), found) == expected);
+      }
+    }
+  }
+}
@@ -0,0 +1,61 @@
+#include <catch.hpp>
+
+#include "cache.h"
+#include "defaults.hpp"
+#include "mocks.hpp"
+
+SCENARIO("A batch of prefetches is deduplicated and limited by the prefetch queue")
+{
+  GIVEN("An empty cache with a prefetch queue of four entries")
+  {
+    constexpr unsigned pq_size = 4;
+    do_nothing_MRC mock_ll;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}.name("427-uut").lower_level(&mock_ll.queues).pq_size(pq_size)};
+
+    std::array<champsim::operable*, 2> elements{{&mock_ll, &uut}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("A batch with a duplicated block is issued")
+    {
+      std::vector<champsim::prefetch_request> batch{
+          {champsim::address{0xdeadbe00}, true, 0}, {champsim::address{0xdeadbe40}, true, 0}, {champsim::address{0xdeadbe08}, true, 0}};
+      auto accepted = uut.prefetch_lines(batch);
+
+      THEN("Every request is accepted") { REQUIRE(accepted == std::size(batch)); }
+
+      THEN("Every request is counted, but only the distinct blocks are issued")
+      {
+        CHECK(uut.sim_stats.pf_requested == 3);
+        CHECK(uut.sim_stats.pf_filtered == 1);
+        CHECK(uut.sim_stats.pf_issued == 2);
+        CHECK(uut.get_pq_occupancy().back() == 2);
+      }
+
+      AND_WHEN("A batch that overflows the prefetch queue is issued")
+      {
+        std::vector<champsim::prefetch_request> overflow{{champsim::address{0xcafeba00}, true, 0},
+                                                         {champsim::address{0xcafeba08}, true, 0},
+                                                         {champsim::address{0xcafeba40}, true, 0},
+                                                         {champsim::address{0xcafeba80}, true, 0},
+                                                         {champsim::address{0xcafebac0}, true, 0}};
+        auto overflow_accepted = uut.prefetch_lines(overflow);
+
+        THEN("The requests up to the end of the queue are accepted") { REQUIRE(overflow_accepted == 3); }
+
+        THEN("The remaining requests are dropped")
+        {
+          CHECK(uut.sim_stats.pf_requested == 8);
+          CHECK(uut.sim_stats.pf_filtered == 2);
+          CHECK(uut.sim_stats.pf_issued == 4);
+          CHECK(uut.sim_stats.pf_dropped == 2);
+          CHECK(uut.get_pq_occupancy().back() == pq_size);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,88 @@
+#include <catch.hpp>
+
+#include "cache.h"
+#include "defaults.hpp"
+#include "mocks.hpp"
+
+SCENARIO("The prefetch filter drops prefetches for blocks that are pending or resident")
+{
+  GIVEN("An empty cache with a prefetch filter")
+  {
+    constexpr auto hit_latency = 2;
+    constexpr auto miss_latency = 3;
+    constexpr auto fill_latency = 2;
+    do_nothing_MRC mock_ll{miss_latency};
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+                  .name("428-uut")
+                  .sets(64)
+                  .lower_level(&mock_ll.queues)
+                  .hit_latency(hit_latency)
+                  .fill_latency(fill_latency)
+                  .prefetch_filter_size(1024)};
+
+    std::array<champsim::operable*, 2> elements{{&mock_ll, &uut}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("The same block is prefetched twice")
+    {
+      auto first_result = uut.prefetch_line(champsim::address{0xdeadbe00}, true, 0);
+      auto second_result = uut.prefetch_line(champsim::address{0xdeadbe08}, true, 0);
+
+      THEN("Both prefetches are accepted")
+      {
+        REQUIRE(first_result);
+        REQUIRE(second_result);
+      }
+
+      THEN("Only the first prefetch is issued, and the second is filtered")
+      {
+        CHECK(uut.sim_stats.pf_requested == 2);
+        CHECK(uut.sim_stats.pf_issued == 1);
+        CHECK(uut.sim_stats.pf_filtered == 1);
+        CHECK(uut.get_pq_occupancy().back() == 1);
+      }
+
+      AND_WHEN("The phase ends")
+      {
+        uut.end_phase(0);
+
+        THEN("The filtered prefetch is counted in the region of interest") { REQUIRE(uut.roi_stats.pf_filtered == 1); }
+      }
+
+      AND_WHEN("The block is filled and prefetched again")
+      {
+        for (uint64_t i = 0; i < 2 * (hit_latency + miss_latency + fill_latency); ++i)
+          for (auto elem : elements)
+            elem->_operate();
+
+        auto third_result = uut.prefetch_line(champsim::address{0xdeadbe00}, true, 0);
+
+        THEN("The prefetch is accepted") { REQUIRE(third_result); }
+
+        THEN("The prefetch of the resident block is filtered")
+        {
+          CHECK(uut.sim_stats.pf_issued == 1);
+          CHECK(uut.sim_stats.pf_filtered == 2);
+          CHECK(mock_ll.packet_count() == 1);
+        }
+      }
+    }
+
+    WHEN("Different blocks are prefetched")
+    {
+      uut.prefetch_line(champsim::address{0xdeadbe00}, true, 0);
+      uut.prefetch_line(champsim::address{0xcafeba00}, true, 0);
+
+      THEN("Neither prefetch is filtered")
+      {
+        CHECK(uut.sim_stats.pf_issued == 2);
+        CHECK(uut.sim_stats.pf_filtered == 0);
+      }
+    }
+  }
+}
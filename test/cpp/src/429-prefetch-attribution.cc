@@ -0,0 +1,238 @@
+#include <catch.hpp>
+
+#include "cache.h"
+#include "defaults.hpp"
+#include "mocks.hpp"
+#include "modules.h"
+
+namespace
+{
+const champsim::ip_prefetch_stats* find_ip(const std::vector<champsim::ip_prefetch_stats>& stats, uint64_t ip)
+{
+  auto found = std::find_if(std::begin(stats), std::end(stats), [ip](const auto& x) { return x.ip == ip; });
+  return found == std::end(stats) ? nullptr : &*found;
+}
+} // namespace
+
+SCENARIO("The prefetch attribution table keeps the heaviest IPs")
+{
+  GIVEN("A table with room for two IPs")
+  {
+    champsim::prefetch_attribution uut{2};
+
+    WHEN("Two IPs issue prefetches that resolve")
+    {
+      auto first = uut.issue(0x100, 1);
+      auto second = uut.issue(0x200, 1);
+      uut.useful(first, 1);
+      uut.late(second, 1);
+      uut.useless(first, 1);
+
+      THEN("Each outcome is charged to its trigger")
+      {
+        auto stats = uut.top();
+        REQUIRE(std::size(stats) == 2);
+        REQUIRE(find_ip(stats, 0x100) != nullptr);
+        REQUIRE(find_ip(stats, 0x200) != nullptr);
+        CHECK(find_ip(stats, 0x100)->issued == 1);
+        CHECK(find_ip(stats, 0x100)->useful == 1);
+        CHECK(find_ip(stats, 0x100)->useless == 1);
+        CHECK(find_ip(stats, 0x200)->late == 1);
+      }
+
+      THEN("The IPs are ordered by volume")
+      {
+        auto stats = uut.top();
+        CHECK(stats.at(0).ip == 0x100);
+        CHECK(stats.at(0).volume == 3);
+        CHECK(stats.at(1).ip == 0x200);
+        CHECK(stats.at(1).volume == 2);
+      }
+
+      AND_WHEN("A third IP misses")
+      {
+        uut.miss(0x300, 1);
+
+        THEN("It displaces the lightest IP and inherits its volume")
+        {
+          auto stats = uut.top();
+          REQUIRE(std::size(stats) == 2);
+          CHECK(find_ip(stats, 0x200) == nullptr);
+          REQUIRE(find_ip(stats, 0x300) != nullptr);
+          CHECK(find_ip(stats, 0x300)->misses == 1);
+          CHECK(find_ip(stats, 0x300)->volume == 3);
+        }
+
+        THEN("Outcomes of the displaced IP's prefetches are not counted")
+        {
+          uut.useful(second, 1);
+          auto stats = uut.top();
+          CHECK(find_ip(stats, 0x300)->useful == 0);
+          CHECK(find_ip(stats, 0x300)->volume == 3);
+        }
+      }
+    }
+
+    WHEN("The table is cleared")
+    {
+      auto first = uut.issue(0x100, 1);
+      uut.clear();
+      uut.useful(first, 1);
+
+      THEN("No IP is tracked") { CHECK(std::empty(uut.top())); }
+    }
+
+    WHEN("A prefetch has no trigger")
+    {
+      uut.useful(champsim::prefetch_attribution::NONE, 1);
+
+      THEN("Nothing is counted") { CHECK(std::empty(uut.top())); }
+    }
+
+    WHEN("An entry is reassigned more times than a 16-bit generation can count")
+    {
+      auto first = uut.issue(0x100, 1);
+      for (int i = 0; i < 65535; ++i)
+        uut.clear();
+      uut.issue(0x200, 1);
+      uut.useful(first, 1);
+
+      THEN("The old id is still stale")
+      {
+        auto stats = uut.top();
+        REQUIRE(find_ip(stats, 0x200) != nullptr);
+        CHECK(find_ip(stats, 0x200)->useful == 0);
+        CHECK(find_ip(stats, 0x200)->volume == 1);
+      }
+    }
+  }
+
+  GIVEN("A full table whose lightest IP is neither the first nor the last tracked")
+  {
+    champsim::prefetch_attribution uut{4};
+    uut.miss(0x100, 5);
+    uut.miss(0x200, 7);
+    uut.miss(0x300, 1);
+    uut.miss(0x400, 3);
+    uut.covered(0x300, 1);
+
+    WHEN("Another IP misses twice")
+    {
+      uut.miss(0x500, 1);
+      uut.miss(0x500, 1);
+
+      THEN("The lightest IP at each miss is displaced")
+      {
+        auto stats = uut.top();
+        REQUIRE(std::size(stats) == 4);
+        CHECK(find_ip(stats, 0x300) == nullptr);
+        REQUIRE(find_ip(stats, 0x500) != nullptr);
+        CHECK(find_ip(stats, 0x500)->misses == 2);
+        CHECK(find_ip(stats, 0x500)->volume == 4);
+        CHECK(find_ip(stats, 0x400)->volume == 3);
+      }
+
+      AND_WHEN("A further IP misses")
+      {
+        uut.miss(0x600, 1);
+
+        THEN("It displaces the IP that is now the lightest")
+        {
+          auto stats = uut.top();
+          CHECK(find_ip(stats, 0x400) == nullptr);
+          REQUIRE(find_ip(stats, 0x600) != nullptr);
+          CHECK(find_ip(stats, 0x600)->volume == 4);
+          CHECK(find_ip(stats, 0x500) != nullptr);
+        }
+      }
+    }
+  }
+}
+
+namespace
+{
+struct next_line_on_operate : champsim::modules::prefetcher {
+  using prefetcher::prefetcher;
+
+  uint32_t prefetcher_cache_operate(champsim::address addr, champsim::address, uint8_t, bool, access_type, uint32_t metadata_in)
+  {
+    intern_->prefetch_line(champsim::address{champsim::block_number{addr} + 1}, true, metadata_in);
+    return metadata_in;
+  }
+
+  uint32_t prefetcher_cache_fill(champsim::address, long, long, uint8_t, champsim::address, uint32_t metadata_in) { return metadata_in; }
+};
+} // namespace
+
+SCENARIO("A cache attributes prefetch outcomes to the IPs that triggered them")
+{
+  GIVEN("A cache with a next-line prefetcher and prefetch attribution")
+  {
+    constexpr uint64_t hit_latency = 1;
+    constexpr uint64_t fill_latency = 1;
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+                  .name("429-uut")
+                  .upper_levels({&mock_ul.queues})
+                  .lower_level(&mock_ll.queues)
+                  .hit_latency(hit_latency)
+                  .fill_latency(fill_latency)
+                  .prefetch_activate(access_type::LOAD)
+                  .prefetch_attribution(8)
+                  .prefetcher<next_line_on_operate>()};
+
+    std::array<champsim::operable*, 3> elements{{&mock_ll, &mock_ul, &uut}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("A load misses, and a load from another IP hits the prefetched block")
+    {
+      decltype(mock_ul)::request_type seed;
+      seed.address = champsim::address{0xdeadbe00};
+      seed.ip = champsim::address{0x1000};
+      seed.instr_id = 1;
+      seed.cpu = 0;
+      REQUIRE(mock_ul.issue(seed));
+
+      for (auto i = 0; i < 100; ++i)
+        for (auto elem : elements)
+          elem->_operate();
+
+      auto follower = seed;
+      follower.address = champsim::address{0xdeadbe40};
+      follower.ip = champsim::address{0x2000};
+      follower.instr_id = 2;
+      REQUIRE(mock_ul.issue(follower));
+
+      for (auto i = 0; i < 100; ++i)
+        for (auto elem : elements)
+          elem->_operate();
+
+      THEN("The useful prefetch is charged to the first IP, and the coverage to the second")
+      {
+        REQUIRE(uut.sim_stats.pf_useful == 1);
+        auto stats = uut.pf_attribution->top();
+        REQUIRE(find_ip(stats, 0x1000) != nullptr);
+        REQUIRE(find_ip(stats, 0x2000) != nullptr);
+        CHECK(find_ip(stats, 0x1000)->issued == 1);
+        CHECK(find_ip(stats, 0x1000)->useful == 1);
+        CHECK(find_ip(stats, 0x1000)->misses == 1);
+        CHECK(find_ip(stats, 0x2000)->covered == 1);
+        CHECK(find_ip(stats, 0x2000)->misses == 0);
+      }
+
+      AND_WHEN("The phase ends")
+      {
+        for (auto elem : elements)
+          elem->end_phase(0);
+
+        THEN("The per-IP statistics are in the region of interest statistics") { CHECK(std::size(uut.roi_stats.pf_by_ip) == 2); }
+      }
+    }
+  }
+}
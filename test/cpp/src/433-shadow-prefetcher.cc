@@ -0,0 +1,151 @@
+#include <catch.hpp>
+
+#include "cache.h"
+#include "defaults.hpp"
+#include "mocks.hpp"
+#include "modules.h"
+#include "shadow_prefetcher.h"
+
+SCENARIO("A shadow directory scores the prefetches recorded in it")
+{
+  GIVEN("A shadow directory with one set of two ways")
+  {
+    champsim::shadow_directory uut{1, 2};
+
+    WHEN("A prefetched block is demanded by a miss")
+    {
+      uut.prefetch(0x10, false, 1);
+      uut.access(0x10, true, 1);
+
+      THEN("The prefetch is useful and covers the miss")
+      {
+        CHECK(uut.stats.issued == 1);
+        CHECK(uut.stats.useful == 1);
+        CHECK(uut.stats.covered == 1);
+        CHECK(uut.stats.demand_misses == 1);
+      }
+
+      AND_WHEN("The block is demanded again")
+      {
+        uut.access(0x10, true, 1);
+
+        THEN("It is no longer in the directory")
+        {
+          CHECK(uut.stats.useful == 1);
+          CHECK(uut.stats.covered == 1);
+          CHECK(uut.stats.demand_misses == 2);
+        }
+      }
+    }
+
+    WHEN("More blocks are prefetched than fit in the set")
+    {
+      uut.prefetch(0x10, false, 1);
+      uut.prefetch(0x11, false, 1);
+      uut.prefetch(0x12, false, 1);
+
+      THEN("The first prefetch is useless") { CHECK(uut.stats.useless == 1); }
+    }
+
+    WHEN("A block is prefetched twice, or is resident")
+    {
+      uut.prefetch(0x10, false, 1);
+      uut.prefetch(0x10, false, 1);
+      uut.prefetch(0x11, true, 1);
+
+      THEN("Only the first prefetch is issued")
+      {
+        CHECK(uut.stats.issued == 1);
+        CHECK(uut.stats.redundant == 2);
+      }
+    }
+  }
+}
+
+namespace
+{
+struct next_line_shadowed : champsim::modules::prefetcher {
+  using prefetcher::prefetcher;
+
+  uint32_t prefetcher_cache_operate(champsim::address addr, champsim::address, uint8_t, bool, access_type, uint32_t metadata_in)
+  {
+    intern_->prefetch_line(champsim::address{champsim::block_number{addr} + 1}, true, metadata_in);
+    return metadata_in;
+  }
+
+  uint32_t prefetcher_cache_fill(champsim::address, long, long, uint8_t, champsim::address, uint32_t metadata_in) { return metadata_in; }
+};
+} // namespace
+
+SCENARIO("A shadow prefetcher observes the cache without issuing prefetches")
+{
+  GIVEN("A cache with a shadow next-line prefetcher")
+  {
+    constexpr uint64_t hit_latency = 1;
+    constexpr uint64_t fill_latency = 1;
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+                  .name("433-uut")
+                  .upper_levels({&mock_ul.queues})
+                  .lower_level(&mock_ll.queues)
+                  .hit_latency(hit_latency)
+                  .fill_latency(fill_latency)
+                  .prefetch_activate(access_type::LOAD)
+                  .prefetcher<champsim::shadow_prefetcher<next_line_shadowed>>()};
+
+    std::array<champsim::operable*, 3> elements{{&mock_ll, &mock_ul, &uut}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("Two consecutive blocks are loaded")
+    {
+      decltype(mock_ul)::request_type seed;
+      seed.address = champsim::address{0xdeadbe00};
+      seed.instr_id = 1;
+      seed.cpu = 0;
+      REQUIRE(mock_ul.issue(seed));
+
+      for (auto i = 0; i < 100; ++i)
+        for (auto elem : elements)
+          elem->_operate();
+
+      auto follower = seed;
+      follower.address = champsim::address{0xdeadbe40};
+      follower.instr_id = 2;
+      REQUIRE(mock_ul.issue(follower));
+
+      for (auto i = 0; i < 100; ++i)
+        for (auto elem : elements)
+          elem->_operate();
+
+      THEN("No prefetch reaches the lower level")
+      {
+        CHECK(uut.sim_stats.pf_issued == 0);
+        CHECK(mock_ll.packet_count() == 2);
+      }
+
+      THEN("The shadow prefetch of the second block covers its miss")
+      {
+        REQUIRE(std::size(uut.shadow_directories) == 1);
+        const auto& stats = uut.shadow_directories.front().stats;
+        CHECK(stats.issued == 2);
+        CHECK(stats.useful == 1);
+        CHECK(stats.covered == 1);
+        CHECK(stats.demand_misses == 2);
+      }
+
+      AND_WHEN("The phase ends")
+      {
+        for (auto elem : elements)
+          elem->end_phase(0);
+
+        THEN("The shadow statistics are in the region of interest statistics") { CHECK(std::size(uut.roi_stats.pf_shadow) == 1); }
+      }
+    }
+  }
+}
@@ -0,0 +1,85 @@
+#include <catch.hpp>
+
+#include "cache.h"
+#include "defaults.hpp"
+#include "mocks.hpp"
+#include "tracereader.h"
+#include "../prefetcher/oracle/oracle.h"
+
+namespace
+{
+// Each instruction loads the next block
+struct streaming_trace {
+  uint64_t count = 0;
+
+  ooo_model_instr operator()()
+  {
+    input_instr instr{};
+    instr.ip = 0x400000;
+    instr.source_memory[0] = 0x10000000 + 64 * count++;
+    return ooo_model_instr{0, instr};
+  }
+};
+
+struct oracle_distance_four : oracle {
+  explicit oracle_distance_four(CACHE* cache) : oracle(cache, 4) {}
+};
+} // namespace
+
+SCENARIO("The oracle prefetcher prefetches the blocks that the trace is about to access")
+{
+  GIVEN("A cache with an oracle prefetcher four instructions ahead of its core's trace")
+  {
+    champsim::tracereader trace{streaming_trace{}};
+    champsim::lookahead::attach(0, &trace);
+
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+                  .name("434-uut")
+                  .upper_levels({&mock_ul.queues})
+                  .lower_level(&mock_ll.queues)
+                  .pq_size(16)
+                  .prefetcher<oracle_distance_four>()};
+
+    std::array<champsim::operable*, 3> elements{{&mock_ll, &mock_ul, &uut}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("The cache operates")
+    {
+      for (auto i = 0; i < 100; ++i)
+        for (auto elem : elements)
+          elem->_operate();
+
+      THEN("The blocks of the next four instructions are prefetched")
+      {
+        CHECK(uut.sim_stats.pf_issued == 4);
+        CHECK_THAT(mock_ll.addresses, Catch::Matchers::RangeEquals(std::vector<champsim::address>{
+                                          champsim::address{0x10000000}, champsim::address{0x10000040}, champsim::address{0x10000080}, champsim::address{0x100000c0}}));
+      }
+
+      AND_WHEN("The core reads two instructions")
+      {
+        trace();
+        trace();
+
+        for (auto i = 0; i < 100; ++i)
+          for (auto elem : elements)
+            elem->_operate();
+
+        THEN("The blocks of the next two instructions are prefetched")
+        {
+          CHECK(uut.sim_stats.pf_issued == 6);
+          CHECK(mock_ll.addresses.back() == champsim::address{0x10000140});
+        }
+      }
+    }
+
+    champsim::lookahead::attach(0, nullptr);
+  }
+}
@@ -0,0 +1,95 @@
+#include <catch.hpp>
+
+#include <array>
+#include <numeric>
+
+#include "cache.h"
+#include "defaults.hpp"
+#include "../replacement/ucp/ucp.h"
+
+TEST_CASE("UCP lookahead gives ways to the core that benefits from them")
+{
+  // Core 0 gets all of its hits in the first two ways, core 1 keeps gaining hits up to eight ways
+  std::vector<std::vector<uint64_t>> position_hits{{100, 50, 0, 0, 0, 0, 0, 0}, {40, 40, 40, 40, 40, 40, 40, 40}};
+
+  auto allocation = ucp::lookahead(position_hits, 8);
+  REQUIRE(allocation == std::vector<long>{2, 6});
+}
+
+TEST_CASE("UCP lookahead looks past a plateau in the utility curve")
+{
+  // Core 1 gains nothing from its second and third ways, but a great deal from its fourth
+  std::vector<std::vector<uint64_t>> position_hits{{100, 10, 10, 10}, {100, 0, 0, 90}};
+
+  auto allocation = ucp::lookahead(position_hits, 5);
+  REQUIRE(allocation == std::vector<long>{1, 4});
+}
+
+TEST_CASE("UCP lookahead gives every core at least one way")
+{
+  std::vector<std::vector<uint64_t>> position_hits{{0, 0, 0, 0}, {10, 10, 10, 10}, {0, 0, 0, 0}};
+
+  auto allocation = ucp::lookahead(position_hits, 4);
+  REQUIRE(std::all_of(std::cbegin(allocation), std::cend(allocation), [](auto x) { return x >= 1; }));
+  REQUIRE(std::accumulate(std::cbegin(allocation), std::cend(allocation), 0L) == 4);
+  REQUIRE(allocation.at(1) == 2);
+}
+
+TEST_CASE("UCP lookahead does not hand out more ways than there are")
+{
+  std::vector<std::vector<uint64_t>> position_hits{{0, 0}, {10, 10}, {0, 0}, {5, 0}};
+
+  auto allocation = ucp::lookahead(position_hits, 2);
+  REQUIRE(std::accumulate(std::cbegin(allocation), std::cend(allocation), 0L) == 2);
+}
+
+TEST_CASE("UCP does not start with more ways than there are")
+{
+  CACHE cache{champsim::cache_builder{champsim::defaults::default_llc}.name("445-uut").sets(1).ways(2)};
+  ucp uut{&cache, 1, 2, ucp::DEFAULT_EPOCH_ACCESSES, 4};
+
+  REQUIRE(uut.allocation() == std::vector<long>{1, 1, 0, 0});
+}
+
+SCENARIO("UCP only takes victims from cores above their allocation")
+{
+  GIVEN("A four-way set shared by three cores, where core 0 holds more than its allocation")
+  {
+    // The initial allocation is two ways for core 0 and one way each for cores 1 and 2
+    CACHE cache{champsim::cache_builder{champsim::defaults::default_llc}.name("445-uut").sets(1).ways(4)};
+    ucp uut{&cache, 1, 4, ucp::DEFAULT_EPOCH_ACCESSES, 3};
+    REQUIRE(uut.allocation() == std::vector<long>{2, 1, 1});
+
+    std::array<champsim::cache_block, 4> set{};
+    for (auto& blk : set) {
+      blk.valid = true;
+    }
+
+    // Way 0 holds the least recently used block, and belongs to core 1, which is at its allocation
+    uut.replacement_cache_fill(1, 0, 0, champsim::address{0x1000}, champsim::address{}, champsim::address{}, access_type::LOAD);
+    uut.replacement_cache_fill(0, 0, 1, champsim::address{0x2000}, champsim::address{}, champsim::address{}, access_type::LOAD);
+    uut.replacement_cache_fill(0, 0, 2, champsim::address{0x3000}, champsim::address{}, champsim::address{}, access_type::LOAD);
+    uut.replacement_cache_fill(0, 0, 3, champsim::address{0x4000}, champsim::address{}, champsim::address{}, access_type::LOAD);
+
+    WHEN("Core 2, which holds no blocks, misses")
+    {
+      auto victim = uut.find_victim(2, 0, 0, std::data(set), champsim::address{}, champsim::address{0x5000}, access_type::LOAD);
+
+      THEN("The victim is the least recently used block of core 0") { REQUIRE(victim == 1); }
+    }
+
+    WHEN("Core 1, which is at its allocation, misses")
+    {
+      auto victim = uut.find_victim(1, 0, 0, std::data(set), champsim::address{}, champsim::address{0x5000}, access_type::LOAD);
+
+      THEN("The victim is its own block") { REQUIRE(victim == 0); }
+    }
+
+    WHEN("Core 0, which is above its allocation, misses")
+    {
+      auto victim = uut.find_victim(0, 0, 0, std::data(set), champsim::address{}, champsim::address{0x5000}, access_type::LOAD);
+
+      THEN("The victim is its own least recently used block") { REQUIRE(victim == 1); }
+    }
+  }
+}
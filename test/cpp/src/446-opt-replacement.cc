@@ -0,0 +1,151 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include <zlib.h>
+
+#include "cache.h"
+#include "defaults.hpp"
+#include "../replacement/opt/opt.h"
+
+namespace
+{
+constexpr auto NEVER = belady::next_use_window::NEVER;
+
+// Write an index of the given blocks, linking each access to the next access to the same block
+void write_index(const std::string& file_name, const std::vector<uint64_t>& blocks)
+{
+  std::vector<belady::next_use_record> records;
+  for (std::size_t i = 0; i < std::size(blocks); ++i) {
+    auto next = std::find(std::next(std::begin(blocks), static_cast<long>(i) + 1), std::end(blocks), blocks[i]);
+    records.push_back({blocks[i], next == std::end(blocks) ? NEVER : static_cast<uint64_t>(std::distance(std::begin(blocks), next))});
+  }
+
+  auto file = ::gzopen(file_name.c_str(), "wb");
+  ::gzwrite(file, std::data(belady::next_use_window::MAGIC), static_cast<unsigned>(std::size(belady::next_use_window::MAGIC)));
+  ::gzwrite(file, std::data(records), static_cast<unsigned>(std::size(records) * sizeof(belady::next_use_record)));
+  ::gzclose(file);
+}
+} // namespace
+
+SCENARIO("The next-use window follows the accesses through the index")
+{
+  GIVEN("An index in which one block is accessed twice") {
+    const std::string file_name{"446-opt-replacement.window.gz"};
+    write_index(file_name, {0xa, 0xb, 0xa, 0xc});
+
+    belady::next_use_window uut{16};
+    uut.open(file_name);
+
+    THEN("Each block is next accessed at its first record") {
+      CHECK(uut.peek(0xa) == 0);
+      CHECK(uut.peek(0xb) == 1);
+      CHECK(uut.peek(0xc) == 3);
+      CHECK(uut.peek(0xd) == NEVER);
+    }
+
+    WHEN("The repeated block is accessed") {
+      auto next_use = uut.match(0xa);
+
+      THEN("Its next access is its second record") {
+        CHECK(next_use == 2);
+        CHECK(uut.peek(0xa) == 2);
+        CHECK(uut.matched == 1);
+      }
+
+      AND_WHEN("It is accessed again") {
+        next_use = uut.match(0xa);
+
+        THEN("It is not accessed after that") {
+          CHECK(next_use == NEVER);
+          CHECK(uut.peek(0xa) == NEVER);
+        }
+      }
+    }
+
+    WHEN("A block that is not in the index is accessed") {
+      auto next_use = uut.match(0xd);
+
+      THEN("Nothing is consumed") {
+        CHECK(next_use == NEVER);
+        CHECK(uut.unmatched == 1);
+        CHECK(uut.peek(0xa) == 0);
+      }
+    }
+
+    std::remove(file_name.c_str());
+  }
+
+  GIVEN("An index longer than the window") {
+    const std::string file_name{"446-opt-replacement.sliding.gz"};
+    write_index(file_name, {0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7});
+
+    belady::next_use_window uut{4};
+    uut.open(file_name);
+
+    THEN("Only the first records are in the window") {
+      CHECK(uut.peek(0x3) == 3);
+      CHECK(uut.peek(0x4) == NEVER);
+    }
+
+    WHEN("An access matches a record more than half the window past an unmatched one") {
+      uut.match(0x3);
+
+      THEN("The unmatched record is dropped, and the window slides") {
+        CHECK(uut.dropped == 1);
+        CHECK(uut.peek(0x0) == NEVER);
+        CHECK(uut.peek(0x1) == 1);
+        CHECK(uut.peek(0x4) == 4);
+      }
+    }
+
+    std::remove(file_name.c_str());
+  }
+}
+
+SCENARIO("OPT replacement evicts the block that is accessed furthest in the future")
+{
+  GIVEN("A set of four blocks, and an index of their future accesses") {
+    const std::string file_name{"446-opt-replacement.victim.gz"};
+    write_index(file_name, {0x1, 0x2, 0x3, 0x4, 0x3, 0x1, 0x4, 0x2});
+
+    CACHE cache{champsim::cache_builder{champsim::defaults::default_llc}.name("446-uut").sets(1).ways(4)};
+    opt uut{&cache, 1, 4, 16};
+    uut.open(file_name);
+
+    for (long way = 0; way < 4; ++way) {
+      champsim::address addr{champsim::block_number{static_cast<uint64_t>(way + 1)}};
+      uut.update_replacement_state(0, 0, way, addr, champsim::address{}, champsim::address{}, access_type::LOAD, false);
+      uut.replacement_cache_fill(0, 0, way, addr, champsim::address{}, champsim::address{}, access_type::LOAD);
+    }
+
+    THEN("The block that is accessed last is the victim") {
+      CHECK(uut.find_victim(0, 0, 0, nullptr, champsim::address{}, champsim::address{}, access_type::LOAD) == 1);
+    }
+
+    WHEN("The blocks are accessed until none of them is accessed again") {
+      for (uint64_t block : {0x3, 0x1, 0x4, 0x2}) {
+        champsim::address addr{champsim::block_number{block}};
+        uut.update_replacement_state(0, 0, static_cast<long>(block - 1), addr, champsim::address{}, champsim::address{}, access_type::LOAD, true);
+      }
+
+      THEN("The lowest way is the victim") {
+        CHECK(uut.find_victim(0, 0, 0, nullptr, champsim::address{}, champsim::address{}, access_type::LOAD) == 0);
+      }
+    }
+
+    WHEN("Writebacks are made to the blocks") {
+      for (long way = 0; way < 4; ++way) {
+        champsim::address addr{champsim::block_number{static_cast<uint64_t>(way + 1)}};
+        uut.update_replacement_state(0, 0, way, addr, champsim::address{}, champsim::address{}, access_type::WRITE, true);
+      }
+
+      THEN("They do not move through the index") {
+        CHECK(uut.find_victim(0, 0, 0, nullptr, champsim::address{}, champsim::address{}, access_type::LOAD) == 1);
+      }
+    }
+
+    std::remove(file_name.c_str());
+  }
+}
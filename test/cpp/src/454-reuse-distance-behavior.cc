@@ -0,0 +1,106 @@
+#include <catch.hpp>
+
+#include "../../../prefetcher/next_line/next_line.h"
+#include "../../../prefetcher/reuse_distance/reuse_distance.h"
+#include "cache.h"
+#include "defaults.hpp"
+#include "mocks.hpp"
+
+SCENARIO("The reuse distance sampler counts distinct blocks between reuses")
+{
+  GIVEN("A sampler that can track every block")
+  {
+    reuse_distance_sampler uut{1024};
+
+    WHEN("Three blocks are accessed and the first is reused")
+    {
+      auto first = uut.access(0xa);
+      uut.access(0xb);
+      uut.access(0xc);
+      uut.access(0xb);
+      auto reuse = uut.access(0xa);
+
+      THEN("Every block is sampled") { REQUIRE(uut.sampling_rate() == 1.0); }
+
+      THEN("The first access is cold")
+      {
+        REQUIRE(first.has_value());
+        REQUIRE_FALSE(first->distance.has_value());
+      }
+
+      THEN("The reuse distance counts each intervening block once")
+      {
+        REQUIRE(reuse.has_value());
+        REQUIRE(reuse->distance == 2.0);
+        REQUIRE(reuse->weight == 1.0);
+      }
+    }
+
+    WHEN("A block is accessed twice in a row")
+    {
+      uut.access(0xa);
+      auto reuse = uut.access(0xa);
+
+      THEN("The reuse distance is zero") { REQUIRE(reuse->distance == 0.0); }
+    }
+  }
+
+  GIVEN("A sampler that can track only a few blocks")
+  {
+    constexpr std::size_t max_tracked = 16;
+    reuse_distance_sampler uut{max_tracked};
+
+    WHEN("Many distinct blocks are accessed")
+    {
+      for (uint64_t block = 0; block < 10000; ++block)
+        uut.access(block);
+
+      THEN("The memory used stays bounded and the sampling rate drops")
+      {
+        REQUIRE(uut.tracked_blocks() <= max_tracked);
+        REQUIRE(uut.sampling_rate() < 1.0);
+      }
+    }
+  }
+}
+
+SCENARIO("The reuse distance profiler does not disturb a chained prefetcher")
+{
+  GIVEN("A cache with the reuse distance profiler chained with the next_line prefetcher")
+  {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_l1d}
+                  .name("454-uut")
+                  .upper_levels({&mock_ul.queues})
+                  .lower_level(&mock_ll.queues)
+                  .prefetcher<reuse_distance, next_line>()};
+
+    std::array<champsim::operable*, 3> elements{{&mock_ll, &mock_ul, &uut}};
+
+    for (auto elem : elements) {
+      elem->initialize();
+      elem->warmup = false;
+      elem->begin_phase();
+    }
+
+    WHEN("A load is issued")
+    {
+      decltype(mock_ul)::request_type test;
+      test.address = champsim::address{0xdeadbeef};
+      test.cpu = 0;
+      test.type = access_type::LOAD;
+      auto test_result = mock_ul.issue(test);
+
+      for (int i = 0; i < 100; ++i)
+        for (auto elem : elements)
+          elem->_operate();
+
+      THEN("The next line is still prefetched")
+      {
+        REQUIRE(test_result);
+        REQUIRE(uut.sim_stats.pf_issued == 1);
+      }
+    }
+  }
+}
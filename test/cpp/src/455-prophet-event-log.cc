@@ -0,0 +1,51 @@
+#include <catch.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <zlib.h>
+
+#include "../prefetcher/prophet_profile/event_log.h"
+
+TEST_CASE("The prophet event log writes records and their triggers through a bounded buffer")
+{
+  const std::string file_name{"455-prophet-event-log.events.gz"};
+
+  // A buffer smaller than one record forces a hand-off to the writer on every record
+  prophet::event_log uut{16};
+  REQUIRE(uut.open(file_name));
+
+  constexpr uint64_t num_records = 100;
+  for (uint64_t i = 0; i < num_records; ++i) {
+    uut.record({i, 0xcafe, 0x1000 + i, 0x2000 + i, 0, prophet::event_type::MISS, prophet::event_detail::L2PQ}, {i, i + 1});
+  }
+  uut.close();
+  REQUIRE(uut.events() == num_records);
+
+  auto file = ::gzopen(file_name.c_str(), "rb");
+  REQUIRE(file != nullptr);
+
+  char magic[std::size(prophet::event_log::MAGIC)];
+  REQUIRE(::gzread(file, magic, sizeof(magic)) == sizeof(magic));
+  REQUIRE(std::string_view{magic, sizeof(magic)} == prophet::event_log::MAGIC);
+
+  for (uint64_t i = 0; i < num_records; ++i) {
+    prophet::event_record rec;
+    REQUIRE(::gzread(file, &rec, sizeof(rec)) == sizeof(rec));
+    CHECK(rec.cycle == i);
+    CHECK(rec.addr == 0x1000 + i);
+    CHECK(rec.other == 0x2000 + i);
+    CHECK(rec.type == prophet::event_type::MISS);
+    CHECK(rec.detail == prophet::event_detail::L2PQ);
+    REQUIRE(rec.trigger_count == 2);
+
+    uint64_t triggers[2];
+    REQUIRE(::gzread(file, triggers, sizeof(triggers)) == sizeof(triggers));
+    CHECK(triggers[0] == i);
+    CHECK(triggers[1] == i + 1);
+  }
+
+  char extra;
+  CHECK(::gzread(file, &extra, 1) == 0);
+  ::gzclose(file);
+  std::remove(file_name.c_str());
+}
@@ -0,0 +1,80 @@
+#include <catch.hpp>
+
+#include "../prefetcher/prophet_profile/prophet_profile.h"
+
+SCENARIO("The prophet metadata table finds the entries it has inserted")
+{
+  GIVEN("An empty table") {
+    ProphetMetaTable uut{16, 4};
+    uut.track_triggers = true;
+
+    THEN("No key is found") {
+      REQUIRE(uut.find(0x100) == nullptr);
+    }
+
+    WHEN("Entries are inserted into one set") {
+      bool evicted = false;
+      for (uint64_t i = 0; i < 4; ++i)
+        evicted = evicted || uut.insert(i * uut.num_sets, ProphetMetaTableEntry{0x1000 + i});
+
+      THEN("Nothing is evicted and every entry is found") {
+        REQUIRE_FALSE(evicted);
+        for (uint64_t i = 0; i < 4; ++i) {
+          REQUIRE(uut.find(i * uut.num_sets) != nullptr);
+          CHECK(uut.find(i * uut.num_sets)->correlatedAddr == 0x1000 + i);
+        }
+      }
+
+      THEN("The reverse table maps each correlated address back to its trigger") {
+        auto triggers = uut.reverse_metatable.triggers(0x1002);
+        CHECK(std::vector<uint64_t>(std::begin(triggers), std::end(triggers)) == std::vector<uint64_t>{2 * uut.num_sets});
+      }
+
+      AND_WHEN("An entry is erased") {
+        REQUIRE(uut.erase(uut.num_sets));
+
+        THEN("It is no longer found, and its way is reused without an eviction") {
+          CHECK(uut.find(uut.num_sets) == nullptr);
+          CHECK_FALSE(uut.insert(7 * uut.num_sets, ProphetMetaTableEntry{0x2000}));
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("The prophet metadata table evicts the most recently used entry of the lowest priority")
+{
+  GIVEN("A full set with mixed priorities") {
+    ProphetMetaTable uut{16, 4};
+    uut.track_triggers = true;
+    uut.insert(0 * uut.num_sets, ProphetMetaTableEntry{0x1000}, 1);
+    uut.insert(1 * uut.num_sets, ProphetMetaTableEntry{0x1001}, 0);
+    uut.insert(2 * uut.num_sets, ProphetMetaTableEntry{0x1002}, 0);
+    uut.insert(3 * uut.num_sets, ProphetMetaTableEntry{0x1003}, 1);
+
+    WHEN("An older low-priority entry is touched and a new key is inserted") {
+      uut.set_mru(1 * uut.num_sets);
+      bool evicted = uut.insert(4 * uut.num_sets, ProphetMetaTableEntry{0x1004}, 1);
+
+      THEN("The touched entry is the victim") {
+        REQUIRE(evicted);
+        CHECK(uut.find(1 * uut.num_sets) == nullptr);
+        CHECK(uut.find(2 * uut.num_sets) != nullptr);
+        CHECK(uut.find(4 * uut.num_sets) != nullptr);
+        CHECK(uut.reverse_metatable.triggers(0x1001).empty());
+      }
+    }
+
+    WHEN("A present key is inserted again") {
+      bool evicted = uut.insert(2 * uut.num_sets, ProphetMetaTableEntry{0x3000}, 1);
+
+      THEN("Its entry is replaced in place") {
+        REQUIRE(evicted);
+        REQUIRE(uut.find(2 * uut.num_sets) != nullptr);
+        CHECK(uut.find(2 * uut.num_sets)->correlatedAddr == 0x3000);
+        for (uint64_t i : {0, 1, 3})
+          CHECK(uut.find(i * uut.num_sets) != nullptr);
+      }
+    }
+  }
+}
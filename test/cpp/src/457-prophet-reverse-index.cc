@@ -0,0 +1,88 @@
+#include <catch.hpp>
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "../prefetcher/prophet_profile/reverse_index.h"
+
+namespace
+{
+std::vector<uint64_t> to_vector(prophet::trigger_view view) { return {std::begin(view), std::end(view)}; }
+} // namespace
+
+SCENARIO("The prophet reverse index keeps the triggers of a target in order")
+{
+  GIVEN("An empty index") {
+    prophet::reverse_index uut;
+
+    THEN("Every target has no triggers") {
+      REQUIRE(uut.triggers(0x100).empty());
+      REQUIRE(uut.size() == 0);
+    }
+
+    WHEN("More triggers are added to a target than fit inline") {
+      for (uint64_t trigger : {40, 10, 30, 20, 10})
+        uut.insert(0x100, trigger);
+
+      THEN("They are all returned, sorted and without duplicates") {
+        REQUIRE(to_vector(uut.triggers(0x100)) == std::vector<uint64_t>{10, 20, 30, 40});
+      }
+
+      AND_WHEN("They are erased down to fewer than fit inline") {
+        uut.erase(0x100, 20);
+        uut.erase(0x100, 40);
+        uut.erase(0x100, 50);
+
+        THEN("The remaining triggers are returned") {
+          REQUIRE(to_vector(uut.triggers(0x100)) == std::vector<uint64_t>{10, 30});
+        }
+      }
+
+      AND_WHEN("They are all erased") {
+        for (uint64_t trigger : {10, 20, 30, 40})
+          uut.erase(0x100, trigger);
+
+        THEN("The target is removed") {
+          REQUIRE(uut.triggers(0x100).empty());
+          REQUIRE(uut.size() == 0);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("The prophet reverse index agrees with a map of sets across growth and removal")
+{
+  prophet::reverse_index uut{4};
+  std::map<uint64_t, std::set<uint64_t>> reference;
+
+  uint64_t state = 1;
+  auto next = [&state] {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return state >> 33;
+  };
+
+  for (int i = 0; i < 20000; ++i) {
+    uint64_t target = next() % 512;
+    uint64_t trigger = next() % 8;
+    if (next() % 3 == 0) {
+      uut.erase(target, trigger);
+      if (auto found = reference.find(target); found != std::end(reference)) {
+        found->second.erase(trigger);
+        if (std::empty(found->second))
+          reference.erase(found);
+      }
+    } else {
+      uut.insert(target, trigger);
+      reference[target].insert(trigger);
+    }
+  }
+
+  REQUIRE(uut.size() == std::size(reference));
+  for (uint64_t target = 0; target < 512; ++target) {
+    auto found = reference.find(target);
+    auto expected = (found == std::end(reference)) ? std::vector<uint64_t>{} : std::vector<uint64_t>(std::begin(found->second), std::end(found->second));
+    CHECK(to_vector(uut.triggers(target)) == expected);
+  }
+}
@@ -0,0 +1,64 @@
+#include <catch.hpp>
+
+#include <map>
+
+#include "../prefetcher/prophet_profile/ip_table.h"
+
+SCENARIO("The prophet IP table keeps one record per IP")
+{
+  GIVEN("An empty table") {
+    prophet::ip_table uut{4};
+
+    THEN("No IP is found") {
+      REQUIRE(uut.find(0xcafe) == nullptr);
+    }
+
+    WHEN("Many IPs are added") {
+      for (uint64_t ip = 1; ip <= 100; ++ip)
+        uut[ip].last_addr = ip * 2;
+
+      THEN("Each keeps its own record") {
+        REQUIRE(uut.size() == 100);
+        for (uint64_t ip = 1; ip <= 100; ++ip) {
+          REQUIRE(uut.find(ip) != nullptr);
+          CHECK(uut.find(ip)->last_addr == ip * 2);
+        }
+        CHECK(uut.training_size() == 0);
+      }
+    }
+  }
+}
+
+TEST_CASE("The prophet IP table picks the same training victim as a scan of an ordered map")
+{
+  prophet::ip_table uut;
+  std::map<uint64_t, uint32_t> reference; // ip -> solved
+
+  uint64_t state = 7;
+  auto next = [&state] {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return state >> 33;
+  };
+
+  for (int i = 0; i < 5000; ++i) {
+    uint64_t ip = next() % 64;
+    auto choice = next() % 4;
+    if (choice == 0 && !std::empty(reference)) {
+      auto victim = std::begin(reference);
+      for (auto it = std::begin(reference); it != std::end(reference); ++it) {
+        if (it->second < victim->second)
+          victim = it;
+      }
+      REQUIRE(uut.least_solved().ip == victim->first);
+      uut.retire(uut.least_solved());
+      reference.erase(victim);
+    } else if (choice == 1) {
+      uut.add_solved(uut[ip]);
+      ++reference[ip];
+    } else {
+      uut.train(uut[ip]);
+      reference.try_emplace(ip, 0);
+    }
+    REQUIRE(uut.training_size() == std::size(reference));
+  }
+}
@@ -0,0 +1,72 @@
+#include <catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "../prefetcher/prophet_profile/hints.h"
+
+namespace
+{
+void write_hint_file(const std::string& file_name, std::string_view magic, const std::vector<prophet::hint>& hints)
+{
+  std::ofstream file{file_name, std::ios::binary};
+  uint64_t count = std::size(hints);
+  file.write(std::data(magic), static_cast<std::streamsize>(std::size(magic)));
+  file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+  file.write(reinterpret_cast<const char*>(std::data(hints)), static_cast<std::streamsize>(std::size(hints) * sizeof(prophet::hint)));
+}
+} // namespace
+
+SCENARIO("A hint profile is looked up directly from its mapping")
+{
+  GIVEN("A profile with three hints") {
+    const std::string file_name{"459-prophet-hints.bin"};
+    write_hint_file(file_name, prophet::hint_table::MAGIC,
+                    {{0x100, 3, prophet::hint::INSERT}, {0x200, 0, 0}, {0x300, 7, prophet::hint::INSERT}});
+
+    prophet::hint_table uut;
+    uut.open(file_name);
+
+    THEN("Every hint is found") {
+      REQUIRE(uut.is_open());
+      REQUIRE(uut.size() == 3);
+      REQUIRE(uut.find(0x300) != nullptr);
+      CHECK(uut.find(0x300)->priority == 7);
+      CHECK(uut.find(0x300)->allows_insert());
+      REQUIRE(uut.find(0x200) != nullptr);
+      CHECK_FALSE(uut.find(0x200)->allows_insert());
+    }
+
+    THEN("IPs without a hint are not found") {
+      CHECK(uut.find(0x50) == nullptr);
+      CHECK(uut.find(0x250) == nullptr);
+      CHECK(uut.find(0x400) == nullptr);
+    }
+
+    WHEN("The profile is closed") {
+      uut.close();
+
+      THEN("Nothing is found") {
+        CHECK_FALSE(uut.is_open());
+        CHECK(uut.find(0x100) == nullptr);
+      }
+    }
+
+    std::remove(file_name.c_str());
+  }
+}
+
+TEST_CASE("A file that is not a hint profile is rejected")
+{
+  const std::string file_name{"459-prophet-hints-bad.bin"};
+  write_hint_file(file_name, "NOTHINTS", {{0x100, 3, prophet::hint::INSERT}});
+
+  prophet::hint_table uut;
+  REQUIRE_THROWS_AS(uut.open(file_name), std::runtime_error);
+  REQUIRE_FALSE(uut.is_open());
+  REQUIRE_THROWS_AS(uut.open("459-prophet-hints-missing.bin"), std::runtime_error);
+
+  std::remove(file_name.c_str());
+}
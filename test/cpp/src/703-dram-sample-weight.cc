@@ -0,0 +1,95 @@
+#include <catch.hpp>
+
+#include "cache.h"
+#include "defaults.hpp"
+#include "dram_controller.h"
+#include "mocks.hpp"
+
+SCENARIO("A set-sampled cache tells its lower level the sample weight")
+{
+  GIVEN("A cache that samples one in every four sets")
+  {
+    do_nothing_MRC mock_ll;
+    to_rq_MRP mock_ul;
+    CACHE uut{champsim::cache_builder{champsim::defaults::default_llc}
+                  .name("703-uut")
+                  .sets(64)
+                  .sampled_sets(16)
+                  .upper_levels({&mock_ul.queues})
+                  .lower_level(&mock_ll.queues)};
+
+    WHEN("The cache is initialized")
+    {
+      uut.initialize();
+
+      THEN("Requests on the lower level stand for four accesses each") { REQUIRE(mock_ll.queues.sample_weight == 4); }
+    }
+  }
+}
+
+SCENARIO("The memory controller weights its statistics by the sample weight of the channel")
+{
+  GIVEN("A memory controller behind a channel whose requests stand for four accesses")
+  {
+    constexpr uint32_t weight = 4;
+    champsim::channel channel_uut{32, 32, 32, champsim::data::bits{LOG2_BLOCK_SIZE}, false};
+    channel_uut.sample_weight = weight;
+
+    MEMORY_CONTROLLER uut{champsim::chrono::picoseconds{312},
+                          champsim::chrono::picoseconds{624},
+                          std::size_t{24},
+                          std::size_t{24},
+                          std::size_t{24},
+                          std::size_t{52},
+                          champsim::chrono::microseconds{64000},
+                          {&channel_uut},
+                          64,
+                          64,
+                          1,
+                          champsim::data::bytes{8},
+                          65536,
+                          1024,
+                          1,
+                          8,
+                          4,
+                          8192};
+    uut.warmup = false;
+    uut.channels[0].warmup = false;
+
+    WHEN("A read is serviced")
+    {
+      champsim::channel::request_type read;
+      read.address = champsim::address{0xdeadbe00};
+      read.response_requested = true;
+      REQUIRE(channel_uut.add_rq(read));
+
+      for (int i = 0; i < 1000 && std::empty(channel_uut.returned); ++i) {
+        uut._operate();
+      }
+
+      THEN("The read counts as four row buffer accesses")
+      {
+        REQUIRE(std::size(channel_uut.returned) == 1);
+        CHECK(uut.channels[0].sim_stats.RQ_ROW_BUFFER_HIT + uut.channels[0].sim_stats.RQ_ROW_BUFFER_MISS == weight);
+      }
+    }
+
+    WHEN("A write is serviced")
+    {
+      champsim::channel::request_type write;
+      write.address = champsim::address{0xdeadbe00};
+      write.type = access_type::WRITE;
+      write.response_requested = false;
+      REQUIRE(channel_uut.add_wq(write));
+
+      for (int i = 0; i < 1000; ++i) {
+        uut._operate();
+      }
+
+      THEN("The write counts as four row buffer accesses")
+      {
+        CHECK(uut.channels[0].sim_stats.WQ_ROW_BUFFER_HIT + uut.channels[0].sim_stats.WQ_ROW_BUFFER_MISS == weight);
+      }
+    }
+  }
+}
@@ -172,6 +172,19 @@ class CacheBuilderTests(unittest.TestCase):
         self.get_element_diff(['.set_virtual_prefetch()'], virtual_prefetch=True)
         self.get_element_diff(['.reset_virtual_prefetch()'], virtual_prefetch=False)
 
+    def test_prefetcher_profile(self):
+        self.get_element_diff(['.prefetcher_profile("hints/a.bin")'], prefetcher_profile='hints/a.bin')
+
+    def test_replacement_profile(self):
+        self.get_element_diff(['.replacement_profile("next_use/a.gz")'], replacement_profile='next_use/a.gz')
+
+    def test_prefetch_attribution(self):
+        self.get_element_diff(['.prefetch_attribution(32)'], prefetch_attribution=32)
+
+    def test_lean_blocks(self):
+        self.get_element_diff(['.set_lean_blocks()'], lean_blocks=True)
+        self.get_element_diff(['.reset_lean_blocks()'], lean_blocks=False)
+
     def test_prefetch_activate(self):
         self.get_element_diff(['.prefetch_activate(access_type::LOAD)'], prefetch_activate=['LOAD'])
         self.get_element_diff(['.prefetch_activate(access_type::LOAD, access_type::WRITE)'], prefetch_activate=['LOAD', 'WRITE'])
@@ -184,6 +197,10 @@ class CacheBuilderTests(unittest.TestCase):
         self.get_element_diff(['.prefetcher<class a_class>()'], _prefetcher_data=[{ 'name': 'a', 'class': 'a_class' }])
         self.get_element_diff(['.prefetcher<class a_class, class b_class>()'], _prefetcher_data=[{ 'name': 'a', 'class': 'a_class' }, { 'name': 'b', 'class': 'b_class' }])
 
+    def test_shadow_prefetcher(self):
+        self.get_element_diff(['.prefetcher<class a_class, champsim::shadow_prefetcher<class b_class>>()'],
+                              _prefetcher_data=[{ 'name': 'a', 'class': 'a_class' }, { 'name': 'b', 'class': 'b_class', '_shadow': True }])
+
     def test_replacement(self):
         self.get_element_diff(['.replacement<class a_class>()'], _replacement_data=[{ 'name': 'a', 'class': 'a_class' }])
         self.get_element_diff(['.replacement<class a_class, class b_class>()'], _replacement_data=[{ 'name': 'a', 'class': 'a_class' }, { 'name': 'b', 'class': 'b_class' }])
@@ -220,6 +220,17 @@ class ParseNormalizedTests(unittest.TestCase):
                 is_inst_data = {c['name']:[d['_is_instruction_prefetcher'] for d in c['_prefetcher_data']] for c in caches if c['name'] in cache_names}
                 self.assertEqual(is_inst_data, {n:[True] for n in cache_names})
 
+    def test_shadow_prefetchers_are_marked(self):
+        test_config = config.parse.NormalizedConfiguration({
+            'ooo_cpu': [{ 'name': 'test_cpu', 'L1D': 'test_cache' }],
+            'caches': [{ 'name': 'test_cache', 'prefetcher': 'a', 'shadow_prefetcher': 'b' }]
+        })
+
+        result = test_config.apply_defaults_in(PassthroughContext(), PassthroughContext(), PassthroughContext(), PassthroughContext())
+        cache = next(filter(lambda c: c['name'] == 'test_cache', result[0]['caches']))
+        shadow_data = {d['name']: d.get('_shadow', False) for d in cache['_prefetcher_data']}
+        self.assertEqual(shadow_data, {'a': False, 'b': True})
+
     def test_instruction_and_data_caches_have_translators(self):
         for num_cores in (1,2,4,8):
             with self.subTest(num_cores=num_cores):
@@ -285,6 +296,26 @@ class ParseNormalizedTests(unittest.TestCase):
 
                 self.assertEqual(tlb_names, {c:False for c in tlb_names.keys()})
 
+    def test_caches_do_not_have_lean_blocks_by_default(self):
+        for num_cores in (1,2,4,8):
+            with self.subTest(num_cores=num_cores):
+                test_config = config.parse.NormalizedConfiguration({ 'ooo_cpu': [{ 'name': 'test_cpu'+str(i) } for i in range(num_cores)] })
+
+                result = test_config.apply_defaults_in(PassthroughContext(), PassthroughContext(), PassthroughContext(), PassthroughContext())
+                for cache in result[0]['caches']:
+                    self.assertNotIn('lean_blocks', cache)
+
+    def test_caches_may_request_lean_blocks(self):
+        test_config = config.parse.NormalizedConfiguration({
+            'ooo_cpu': [{ 'name': 'test_cpu0' }],
+            'caches': [{ 'name': 'LLC', 'lean_blocks': True }]
+        })
+
+        result = test_config.apply_defaults_in(PassthroughContext(), PassthroughContext(), PassthroughContext(), PassthroughContext())
+        caches = {cache['name']: cache for cache in result[0]['caches']}
+        self.assertEqual(caches['LLC'].get('lean_blocks'), True)
+        self.assertNotIn('lean_blocks', caches['test_cpu0_L1D'])
+
     def test_caches_inherit_core_frequency(self):
         for num_cores in (1,2,4,8):
             with self.subTest(num_cores=num_cores):